@@ -0,0 +1,188 @@
+//
+//  batch_complexes.cpp
+//  Bistellar
+//
+
+#include "batch_complexes.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include "binary_complex.h"
+#include "complex_homology.h"
+#include "complex_isomorphism.h"
+#include "recognize_manifold.h"
+#include "reduce_complex.h"
+#include "util.h"
+
+bool batch_operation(const std::string & name, batch_operation_t & operation)
+{
+    if (name.compare("reduce") == 0)
+        operation = batch_reduce;
+    else if (name.compare("ismanifold") == 0)
+        operation = batch_ismanifold;
+    else if (name.compare("homology") == 0)
+        operation = batch_homology;
+    else if (name.compare("isosig") == 0)
+        operation = batch_isosig;
+    else if (name.compare("fvector") == 0)
+        operation = batch_fvector;
+    else
+        return false;
+
+    return true;
+}
+
+BatchOptions::BatchOptions() : operation(batch_reduce), rounds(10000), schedule(reduction_schedule("default")), heating(0), relaxation(4), threads(std::thread::hardware_concurrency()), seed(0)
+{
+}
+
+// a complex of the batch, from loading to its result
+struct BatchJob
+{
+    std::string path;
+    face_list_t facets;
+    // empty if the complex was loaded, else why it was not
+    std::string error;
+};
+
+// calls work(i) for every i < count, distributed to threads workers which take the next i as soon as they are done
+template< class Work >
+static void distribute(size_t count, unsigned int threads, Work work)
+{
+    std::atomic< size_t > next(0);
+    auto worker = [&]()
+    {
+        for (size_t i = next++; i < count; i = next++)
+            work(i);
+    };
+
+    threads = static_cast< unsigned int >(std::max< size_t >(1, std::min< size_t >(threads, count)));
+    if (threads == 1)
+    {
+        worker();
+    }
+    else
+    {
+        std::vector< std::thread > workers;
+        for (unsigned int i = 0; i < threads; i++)
+            workers.push_back(std::thread(worker));
+        for (unsigned int i = 0; i < threads; i++)
+            workers[i].join();
+    }
+}
+
+// applies the operation of options to complex and writes its result to os in the format of the single command
+static void processComplex(MovableComplex & complex, const BatchOptions & options, unsigned int seed, std::ostream & os)
+{
+    switch (options.operation)
+    {
+        case batch_reduce:
+        {
+            reduce_complex(complex, options.rounds, *options.schedule, options.heating, options.relaxation, 1, 0, 0, seed);
+            os << "resulting complex is " << complex << " with " << complex.f(0) << " vertices";
+            break;
+        }
+        case batch_ismanifold:
+        {
+            link_verdict_list_t verdicts;
+            manifold_verdict_t verdict = recognize_manifold(complex, options.rounds, *options.schedule, 1, seed, verdicts);
+            os << "resulting manifold is " << (verdict == manifold_true ? "true" : verdict == manifold_false ? "false" : "unknown");
+            break;
+        }
+        case batch_homology:
+        {
+            homology_list_t homology;
+            os << "resulting homology is ";
+            if (complex_homology(complex, homology))
+                list_print(os, homology.begin(), homology.end());
+            else
+                os << "fail";
+            break;
+        }
+        case batch_isosig:
+        {
+            std::string signature;
+            os << "resulting isosig is " << (isomorphism_signature(complex.faces(complex.dimension()), signature) ? signature : std::string("fail"));
+            break;
+        }
+        case batch_fvector:
+        {
+            std::vector< unsigned int > fVector;
+            for (unsigned int d = 0; d < complex.dimension()+1; d++)
+                fVector.push_back(complex.f(d));
+            os << "resulting fvector is ";
+            list_print(os, fVector.begin(), fVector.end());
+            break;
+        }
+    }
+}
+
+void batch_complexes(const std::vector< std::string > & files, const std::string & root, const BatchOptions & options, std::ostream & os)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::vector< BatchJob > jobs(files.size());
+    distribute(jobs.size(), options.threads, [&](size_t i)
+    {
+        jobs[i].path = files[i];
+        if (!read_complex_file(files[i], jobs[i].facets, jobs[i].error))
+            jobs[i].facets.clear();
+        else if (jobs[i].facets.empty())
+            jobs[i].error = "complex has no facets";
+    });
+
+    // the largest complexes are started first, so that none of them is left over for a single worker at the end
+    std::vector< size_t > order(jobs.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    auto size = [&jobs](size_t i)
+    {
+        return jobs[i].facets.empty() ? 0 : jobs[i].facets.size() * (jobs[i].facets.front().dimension()+1);
+    };
+    std::stable_sort(order.begin(), order.end(), [&size](size_t i, size_t j)
+    {
+        return size(i) > size(j);
+    });
+
+    std::mutex output;
+    std::atomic< unsigned int > failed(0);
+    std::atomic< unsigned long long > totalFacets(0);
+    distribute(order.size(), options.threads, [&](size_t k)
+    {
+        BatchJob & job = jobs[order[k]];
+        std::chrono::steady_clock::time_point jobStart = std::chrono::steady_clock::now();
+
+        std::ostringstream record;
+        std::string name = job.path.compare(0, root.size() + 1, root + "/") == 0 ? job.path.substr(root.size() + 1) : job.path;
+        record << "complex " << name << ": ";
+        if (job.error.empty())
+        {
+            totalFacets += job.facets.size();
+            MovableComplex complex(job.facets, job.facets.front().dimension());
+            job.facets.clear();
+
+            std::seed_seq seeds = {options.seed, static_cast< unsigned int >(order[k])};
+            unsigned int seed;
+            seeds.generate(&seed, &seed + 1);
+            processComplex(complex, options, seed, record);
+        }
+        else
+        {
+            failed++;
+            record << "malformed complex: " << job.error;
+        }
+        record << " in " << std::chrono::duration< double, std::milli >(std::chrono::steady_clock::now() - jobStart).count() << " ms\n";
+
+        std::lock_guard< std::mutex > lock(output);
+        os << record.str() << std::flush;
+    });
+
+    double milliseconds = std::chrono::duration< double, std::milli >(std::chrono::steady_clock::now() - start).count();
+    double seconds = std::max(milliseconds / 1000, 1e-9);
+    os << "processed " << jobs.size() << " complexes (" << failed << " malformed) with " << totalFacets << " facets in " << milliseconds << " ms, "
+       << jobs.size() / seconds << " complexes/s and " << totalFacets / seconds << " facets/s" << std::endl;
+}
@@ -0,0 +1,50 @@
+//
+//  batch_complexes.h
+//  Bistellar
+//
+
+#ifndef Bistellar_batch_complexes_h
+#define Bistellar_batch_complexes_h
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "reduction_schedule.h"
+
+// the operation applied to every complex of a batch, as by the command of the same name
+enum batch_operation_t
+{
+    batch_reduce,
+    batch_ismanifold,
+    batch_homology,
+    batch_isosig,
+    batch_fvector
+};
+
+// sets operation to the operation named reduce, ismanifold, homology, isosig or fvector. Returns false if there is none of that name.
+bool batch_operation(const std::string & name, batch_operation_t & operation);
+
+// options of a batch
+struct BatchOptions
+{
+    batch_operation_t operation;
+    // the number of moves of reduce, and per link of ismanifold
+    unsigned int rounds;
+    const ReductionSchedule * schedule;
+    int heating;
+    int relaxation;
+    // the number of threads the complexes are distributed to. Every complex is processed by a single thread.
+    unsigned int threads;
+    unsigned int seed;
+
+    BatchOptions();
+};
+
+// applies the operation of options to the complexes in files, read by read_complex_file. The files are loaded by the
+// workers first, then processed largest first, i.e. by decreasing number of facets times their number of vertices,
+// each worker taking the next complex as soon as it is done with its last one. Every complex draws from its own RNG
+// stream derived from seed and its position in files. A record with the result and the time taken is written to os as
+// soon as a complex is done, naming its file relative to root, followed by a summary of the total throughput.
+void batch_complexes(const std::vector< std::string > & files, const std::string & root, const BatchOptions & options, std::ostream & os);
+
+#endif
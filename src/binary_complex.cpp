@@ -0,0 +1,183 @@
+//
+//  binary_complex.cpp
+//  Bistellar
+//
+
+#include "binary_complex.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "complex_library.h"
+#include "facet_parser.h"
+#include "util.h"
+
+static const char binaryMagic[4] = {'S', 'C', 'B', '1'};
+
+// facets are sanity checked against this number of vertices before any memory is reserved for them
+static const unsigned long long maximalFacetSize = 1 << 16;
+
+static void writeVarint(std::string & buffer, unsigned long long value)
+{
+    while (value >= 0x80)
+    {
+        buffer += static_cast< char >((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    buffer += static_cast< char >(value);
+}
+
+// reads a varint from it and advances it, returns false if the data ends within it or it exceeds 64 bits
+static bool readVarint(const char *& it, const char * last, unsigned long long & value)
+{
+    value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7)
+    {
+        if (it == last)
+            return false;
+
+        unsigned char byte = static_cast< unsigned char >(*it++);
+        value |= static_cast< unsigned long long >(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+// sets error to message at the offset of position and returns 0
+static const char * decodeError(const char * begin, const char * position, const char * message, std::string & error)
+{
+    std::ostringstream os;
+    os << message << " at offset " << (position - begin);
+    error = os.str();
+
+    return 0;
+}
+
+bool is_binary_complex(const char * first, const char * last)
+{
+    return last - first >= static_cast< std::ptrdiff_t >(sizeof(binaryMagic)) && std::equal(binaryMagic, binaryMagic + sizeof(binaryMagic), first);
+}
+
+void encode_facets(const face_set_t & facets, unsigned int dimension, std::string & buffer)
+{
+    std::vector< const Face * > sorted;
+    sorted.reserve(facets.size());
+    for (face_set_t::const_iterator it = facets.begin(); it != facets.end(); it++)
+        sorted.push_back(&*it);
+    std::sort(sorted.begin(), sorted.end(), [dimension](const Face * face1, const Face * face2)
+    {
+        return std::lexicographical_compare(&face1->vertex(0), &face1->vertex(0) + dimension+1, &face2->vertex(0), &face2->vertex(0) + dimension+1);
+    });
+
+    buffer.append(binaryMagic, sizeof(binaryMagic));
+    writeVarint(buffer, dimension);
+    writeVarint(buffer, sorted.size());
+    vertex_t previousFirst = 0;
+    for (std::vector< const Face * >::const_iterator it = sorted.begin(); it != sorted.end(); it++)
+    {
+        const vertex_t * vertices = &(*it)->vertex(0);
+        writeVarint(buffer, vertices[0] - previousFirst);
+        for (unsigned int i = 1; i < dimension+1; i++)
+            writeVarint(buffer, vertices[i] - vertices[i-1] - 1);
+        previousFirst = vertices[0];
+    }
+}
+
+const char * decode_facets(const char * first, const char * last, face_list_t & facets, std::string & error)
+{
+    if (!is_binary_complex(first, last))
+        return decodeError(first, first, "expected the magic SCB1", error);
+
+    const char * it = first + sizeof(binaryMagic);
+    unsigned long long dimension, count;
+    if (!readVarint(it, last, dimension) || dimension + 1 > maximalFacetSize)
+        return decodeError(first, it, "invalid dimension", error);
+    if (!readVarint(it, last, count))
+        return decodeError(first, it, "invalid number of facets", error);
+
+    std::vector< vertex_t > vertices(dimension+1);
+    unsigned long long previousFirst = 0;
+    for (unsigned long long i = 0; i < count; i++)
+    {
+        const char * facetStart = it;
+        unsigned long long vertex = 0;
+        for (unsigned int j = 0; j < dimension+1; j++)
+        {
+            unsigned long long delta;
+            if (!readVarint(it, last, delta))
+                return decodeError(first, it, "truncated facet", error);
+
+            vertex = (j == 0) ? previousFirst + delta : vertex + delta + 1;
+            if (delta > std::numeric_limits< vertex_t >::max() || vertex > std::numeric_limits< vertex_t >::max())
+                return decodeError(first, facetStart, "vertex out of range", error);
+            vertices[j] = static_cast< vertex_t >(vertex);
+        }
+        previousFirst = vertices[0];
+        facets.emplace_back(vertices.data(), static_cast< int >(dimension));
+    }
+
+    return it;
+}
+
+bool read_complex_file(const std::string & path, face_list_t & facets, std::string & error)
+{
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+    {
+        error = "could not open " + path;
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size == 0)
+    {
+        close(descriptor);
+        error = "could not read " + path;
+        return false;
+    }
+
+    size_t size = static_cast< size_t >(status.st_size);
+    void * mapping = mmap(0, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (mapping == MAP_FAILED)
+    {
+        error = "could not map " + path;
+        return false;
+    }
+
+    const char * first = static_cast< const char * >(mapping);
+    const char * end;
+    if (is_binary_complex(first, first + size))
+        end = decode_facets(first, first + size, facets, error);
+    else if (is_library_complex(first, first + size))
+        end = decode_library_complex(first, first + size, facets, error) ? first + size : 0;
+    else
+        end = parse_facets(first, first + size, facets, error);
+    munmap(mapping, size);
+
+    return end != 0;
+}
+
+bool write_complex_file(const std::string & path, const MovableComplex & complex, std::string & error)
+{
+    std::string & buffer = output_buffer();
+    encode_facets(complex.faces(complex.dimension()), complex.dimension(), buffer);
+
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file.write(buffer.data(), buffer.size());
+    if (!file)
+    {
+        error = "could not write " + path;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,37 @@
+//
+//  binary_complex.h
+//  Bistellar
+//
+
+#ifndef Bistellar_binary_complex_h
+#define Bistellar_binary_complex_h
+
+#include <string>
+#include "types.h"
+#include "face.h"
+#include "movable_complex.h"
+
+// The binary format of a complex: the magic "SCB1", the dimension d and the number of facets as varints, then the
+// facets in lexicographic order, each as d+1 varints. The first vertex of a facet is stored as difference to the first
+// vertex of the previous facet, every further vertex as difference to the previous vertex of the facet minus one.
+// Varints store 7 bits per byte, least significant first, with the high bit set on all but the last byte.
+
+// tests if the characters [first, last) start with the magic of the binary format
+bool is_binary_complex(const char * first, const char * last);
+
+// appends the facets of the given dimension in the binary format to buffer
+void encode_facets(const face_set_t & facets, unsigned int dimension, std::string & buffer);
+
+// decodes a complex in the binary format from [first, last) into facets. Returns a pointer past the complex, or 0 if
+// the data is malformed, in which case error describes the problem and its offset from first.
+const char * decode_facets(const char * first, const char * last, face_list_t & facets, std::string & error);
+
+// reads the facets of a complex from the file at path, which is memory-mapped. The file holds a complex in the binary
+// format, pickled by SCSave as the files of the simpcomp library, or as facet list. Returns false and sets error if it
+// cannot be read or is malformed.
+bool read_complex_file(const std::string & path, face_list_t & facets, std::string & error);
+
+// writes complex in the binary format to the file at path. Returns false and sets error if it cannot be written.
+bool write_complex_file(const std::string & path, const MovableComplex & complex, std::string & error);
+
+#endif
@@ -7,6 +7,8 @@
 //
 
 #include "bistellar_move.h"
+#include <utility>
+#include "util.h"
 
 BistellarMove::BistellarMove() : _face(), _link()
 {
@@ -18,10 +20,14 @@ BistellarMove::BistellarMove(const Face & face, const Face & link) : _face(face)
     
 }
 
-BistellarMove::BistellarMove(const BistellarMove & cpy)
+BistellarMove::BistellarMove(const BistellarMove & cpy) : _face(cpy._face), _link(cpy._link)
 {
-    _face = cpy._face;
-    _link = cpy._link;
+    
+}
+
+BistellarMove::BistellarMove(BistellarMove && other) noexcept : _face(std::move(other._face)), _link(std::move(other._link))
+{
+    
 }
 
 BistellarMove & BistellarMove::operator=(const BistellarMove & cpy)
@@ -35,6 +41,17 @@ BistellarMove & BistellarMove::operator=(const BistellarMove & cpy)
     return *this;
 }
 
+BistellarMove & BistellarMove::operator=(BistellarMove && other) noexcept
+{
+    if (this == &other)
+        return *this;
+    
+    _face = std::move(other._face);
+    _link = std::move(other._link);
+    
+    return *this;
+}
+
 BistellarMove::~BistellarMove()
 {
     
@@ -71,9 +88,20 @@ unsigned int BistellarMove::codimension() const
 }
 
 // serialization methods
+void BistellarMove::write(std::string & buffer) const
+{
+    buffer += '[';
+    _face.write(buffer);
+    buffer += ',';
+    _link.write(buffer);
+    buffer += ']';
+}
+
 std::ostream & operator<< (std::ostream & os, const BistellarMove & move)
 {
-    os << "[" << move._face << "," << move._link << "]";
+    std::string & buffer = output_buffer();
+    move.write(buffer);
+    os.write(buffer.data(), buffer.size());
     return os;
 }
 std::istream & operator>> (std::istream & is, BistellarMove & move)
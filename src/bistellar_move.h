@@ -10,6 +10,7 @@
 #define Bistellar_bistellar_move_h
 
 #include <iostream>
+#include <string>
 #include "types.h"
 #include "face.h"
 
@@ -23,7 +24,9 @@ public:
     BistellarMove(const Face & face, const Face & link);
     
     BistellarMove(const BistellarMove & cpy);
+    BistellarMove(BistellarMove && other) noexcept;
     BistellarMove & operator=(const BistellarMove & cpy);
+    BistellarMove & operator=(BistellarMove && other) noexcept;
     
     ~BistellarMove();
     
@@ -36,6 +39,9 @@ public:
     unsigned int dimension() const;
     unsigned int codimension() const;
     
+    // appends the move in the format [face,link] to buffer
+    void write(std::string & buffer) const;
+    
     // serialization methods
     friend std::ostream & operator<< (std::ostream & os, const BistellarMove & move);
     friend std::istream & operator>> (std::istream & is, BistellarMove & move);
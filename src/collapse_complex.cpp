@@ -0,0 +1,290 @@
+//
+//  collapse_complex.cpp
+//  Bistellar
+//
+
+#include "collapse_complex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+#include "hasse_diagram.h"
+
+std::ostream & operator<< (std::ostream & os, const MorseSpectrumEntry & entry)
+{
+    os << "[" << std::accumulate(entry.critical.begin(), entry.critical.end(), 0u) << ",[";
+    for (size_t i = 0; i < entry.critical.size(); i++)
+        os << (i > 0 ? "," : "") << entry.critical[i];
+    os << "]," << entry.count << "]";
+
+    return os;
+}
+
+bool morse_order(const std::string & name, morse_order_t & order)
+{
+    if (name.compare("random") == 0)
+        order = morse_random;
+    else if (name.compare("lex") == 0)
+        order = morse_lex;
+    else if (name.compare("revlex") == 0)
+        order = morse_revlex;
+    else
+        return false;
+
+    return true;
+}
+
+// faces which may be chosen next. Entries are not removed when they become invalid, they are skipped when taken.
+class CandidateList
+{
+    std::deque< unsigned int > _items;
+
+public:
+    bool empty() const
+    {
+        return _items.empty();
+    }
+
+    void push(unsigned int i)
+    {
+        _items.push_back(i);
+    }
+
+    // removes and returns a random, the first or the last candidate
+    unsigned int pop(morse_order_t order, random_engine_t & rng)
+    {
+        if (order == morse_random)
+            std::swap(_items[rng() % _items.size()], _items.back());
+
+        unsigned int i;
+        if (order == morse_lex)
+        {
+            i = _items.front();
+            _items.pop_front();
+        }
+        else
+        {
+            i = _items.back();
+            _items.pop_back();
+        }
+
+        return i;
+    }
+};
+
+// the ids of the faces of every dimension in the order they are considered. For the lexicographic orders, the
+// vertices are relabeled randomly and the faces are sorted by their new labels.
+static void faceOrder(const HasseDiagram & hasse, morse_order_t order, random_engine_t & rng, std::vector< std::vector< unsigned int > > & ids)
+{
+    ids.assign(hasse.dimension()+1, std::vector< unsigned int >());
+    for (unsigned int d = 0; d < hasse.dimension()+1; d++)
+    {
+        ids[d].resize(hasse.f(d));
+        std::iota(ids[d].begin(), ids[d].end(), 0);
+    }
+    if (order == morse_random)
+        return;
+
+    std::vector< unsigned int > labels(hasse.f(0));
+    std::iota(labels.begin(), labels.end(), 0);
+    std::shuffle(labels.begin(), labels.end(), rng);
+    std::unordered_map< vertex_t, unsigned int > newLabel;
+    for (unsigned int i = 0; i < hasse.f(0); i++)
+        newLabel[hasse.face(0, i).vertex(0)] = labels[i];
+
+    for (unsigned int d = 0; d < hasse.dimension()+1; d++)
+    {
+        std::vector< unsigned int > keys((d+1) * hasse.f(d));
+        for (unsigned int i = 0; i < hasse.f(d); i++)
+        {
+            for (unsigned int j = 0; j < d+1; j++)
+                keys[(d+1)*i + j] = newLabel[hasse.face(d, i).vertex(j)];
+            std::sort(keys.begin() + (d+1)*i, keys.begin() + (d+1)*(i+1));
+        }
+        std::sort(ids[d].begin(), ids[d].end(), [&keys, d](unsigned int i, unsigned int j)
+        {
+            return std::lexicographical_compare(keys.begin() + (d+1)*i, keys.begin() + (d+1)*(i+1), keys.begin() + (d+1)*j, keys.begin() + (d+1)*(j+1));
+        });
+    }
+}
+
+// pairs faces with free faces of codimension one from the top dimension down, as SCIntFunc.morseRandom does. If no face of
+// the current dimension is free, a face of it becomes critical, or, if collapse is set, the maximal faces left are stored
+// in remainder and the collapse stops. Returns the number of critical faces of every dimension.
+static std::vector< unsigned int > discreteMorseFunction(const HasseDiagram & hasse, morse_order_t order, random_engine_t & rng, bool collapse, face_list_t * remainder)
+{
+    unsigned int dimension = hasse.dimension();
+    std::vector< std::vector< unsigned int > > ids;
+    faceOrder(hasse, order, rng, ids);
+
+    std::vector< std::vector< char > > removed(dimension+1);
+    // the number of cofaces not removed yet
+    std::vector< std::vector< unsigned int > > cofaces(dimension+1);
+    for (unsigned int d = 0; d < dimension+1; d++)
+    {
+        removed[d].assign(hasse.f(d), 0);
+        cofaces[d].resize(hasse.f(d));
+        for (unsigned int i = 0; i < hasse.f(d); i++)
+            cofaces[d][i] = hasse.numberOfCofaces(d, i);
+    }
+
+    std::vector< unsigned int > critical(dimension+1, 0);
+    for (unsigned int d = dimension; d > 0; d--)
+    {
+        CandidateList free;
+        CandidateList available;
+        for (std::vector< unsigned int >::const_iterator it = ids[d-1].begin(); it != ids[d-1].end(); it++)
+        {
+            if (!removed[d-1][*it] && cofaces[d-1][*it] == 1)
+                free.push(*it);
+        }
+        unsigned int remaining = 0;
+        for (std::vector< unsigned int >::const_iterator it = ids[d].begin(); it != ids[d].end(); it++)
+        {
+            if (!removed[d][*it])
+            {
+                available.push(*it);
+                remaining++;
+            }
+        }
+
+        while (remaining > 0)
+        {
+            unsigned int freeFace = hasse.f(d-1);
+            while (!free.empty() && freeFace == hasse.f(d-1))
+            {
+                unsigned int i = free.pop(order, rng);
+                if (!removed[d-1][i] && cofaces[d-1][i] == 1)
+                    freeFace = i;
+            }
+
+            unsigned int face;
+            if (freeFace == hasse.f(d-1))
+            {
+                if (collapse)
+                {
+                    for (unsigned int e = 0; e < d+1; e++)
+                    {
+                        for (unsigned int i = 0; i < hasse.f(e); i++)
+                        {
+                            if (!removed[e][i] && cofaces[e][i] == 0)
+                                remainder->push_back(hasse.face(e, i));
+                        }
+                    }
+                    return critical;
+                }
+
+                do
+                    face = available.pop(order, rng);
+                while (removed[d][face]);
+                critical[d]++;
+            }
+            else
+            {
+                // the free face is paired with its only coface left
+                const unsigned int * candidates = hasse.cofaces(d-1, freeFace);
+                face = candidates[0];
+                for (unsigned int i = 1; removed[d][face]; i++)
+                    face = candidates[i];
+
+                removed[d-1][freeFace] = 1;
+                if (d > 1)
+                {
+                    const unsigned int * boundary = hasse.boundary(d-1, freeFace);
+                    for (unsigned int j = 0; j < d; j++)
+                        cofaces[d-2][boundary[j]]--;
+                }
+            }
+
+            removed[d][face] = 1;
+            remaining--;
+            const unsigned int * boundary = hasse.boundary(d, face);
+            for (unsigned int j = 0; j < d+1; j++)
+            {
+                if (--cofaces[d-1][boundary[j]] == 1 && !removed[d-1][boundary[j]])
+                    free.push(boundary[j]);
+            }
+        }
+    }
+
+    for (unsigned int i = 0; i < hasse.f(0); i++)
+    {
+        if (!removed[0][i])
+        {
+            critical[0]++;
+            if (collapse)
+                remainder->push_back(hasse.face(0, i));
+        }
+    }
+
+    return critical;
+}
+
+void collapse_complex(const MovableComplex & complex, morse_order_t order, unsigned int seed, face_list_t & remainder)
+{
+    HasseDiagram hasse(complex);
+    std::seed_seq seeds = {seed, 0u};
+    random_engine_t rng(seeds);
+
+    remainder.clear();
+    discreteMorseFunction(hasse, order, rng, true, &remainder);
+}
+
+void morse_spectrum(const MovableComplex & complex, unsigned int samples, morse_order_t order, unsigned int threads, unsigned int seed, morse_spectrum_t & spectrum)
+{
+    HasseDiagram hasse(complex);
+    std::map< std::vector< unsigned int >, unsigned int > counts;
+    std::mutex mutex;
+    std::atomic< unsigned int > nextSample(0);
+
+    auto work = [&]()
+    {
+        std::map< std::vector< unsigned int >, unsigned int > workerCounts;
+        for (unsigned int i = nextSample++; i < samples; i = nextSample++)
+        {
+            std::seed_seq seeds = {seed, i};
+            random_engine_t rng(seeds);
+            std::vector< unsigned int > critical = discreteMorseFunction(hasse, order, rng, false, 0);
+            // as SCMorseVec, the vector ends with the largest dimension with critical faces
+            while (critical.size() > 1 && critical.back() == 0)
+                critical.pop_back();
+            workerCounts[critical]++;
+        }
+
+        std::lock_guard< std::mutex > lock(mutex);
+        for (std::map< std::vector< unsigned int >, unsigned int >::const_iterator it = workerCounts.begin(); it != workerCounts.end(); it++)
+            counts[it->first] += it->second;
+    };
+
+    threads = std::max(1u, std::min(threads, samples));
+    if (threads == 1)
+    {
+        work();
+    }
+    else
+    {
+        std::vector< std::thread > workers;
+        for (unsigned int i = 0; i < threads; i++)
+            workers.push_back(std::thread(work));
+        for (unsigned int i = 0; i < threads; i++)
+            workers[i].join();
+    }
+
+    spectrum.clear();
+    for (std::map< std::vector< unsigned int >, unsigned int >::const_iterator it = counts.begin(); it != counts.end(); it++)
+    {
+        MorseSpectrumEntry entry;
+        entry.critical = it->first;
+        entry.count = it->second;
+        spectrum.push_back(entry);
+    }
+    std::stable_sort(spectrum.begin(), spectrum.end(), [](const MorseSpectrumEntry & entry1, const MorseSpectrumEntry & entry2)
+    {
+        return std::accumulate(entry1.critical.begin(), entry1.critical.end(), 0u) < std::accumulate(entry2.critical.begin(), entry2.critical.end(), 0u);
+    });
+}
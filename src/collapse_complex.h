@@ -0,0 +1,50 @@
+//
+//  collapse_complex.h
+//  Bistellar
+//
+
+#ifndef Bistellar_collapse_complex_h
+#define Bistellar_collapse_complex_h
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "movable_complex.h"
+
+// the order in which free faces and critical faces are chosen, as by SCMorseRandom, SCMorseRandomLex and
+// SCMorseRandomRevLex. The lexicographic orders refer to a random relabeling of the vertices.
+enum morse_order_t
+{
+    morse_random,
+    morse_lex,
+    morse_revlex
+};
+
+// sets order to the order named random, lex or revlex. Returns false if there is none of that name.
+bool morse_order(const std::string & name, morse_order_t & order);
+
+// a vector of critical faces (c_0, ..., c_k) of a discrete Morse function and how often it occurred, where k is
+// the largest dimension with critical faces
+struct MorseSpectrumEntry
+{
+    std::vector< unsigned int > critical;
+    unsigned int count;
+
+    // prints the entry in the format [c_0+...+c_k,[c_0,...,c_k],count] of SCMorseSpec
+    friend std::ostream & operator<< (std::ostream & os, const MorseSpectrumEntry & entry);
+};
+
+// the entries are sorted by the total number of critical faces, then by the vectors
+typedef std::vector< MorseSpectrumEntry > morse_spectrum_t;
+
+// collapses complex greedily as SCCollapseGreedy, pairing free faces with their cofaces from the top dimension down
+// until there are no free faces left. remainder receives the maximal faces of what remains, a single vertex if
+// complex is collapsible.
+void collapse_complex(const MovableComplex & complex, morse_order_t order, unsigned int seed, face_list_t & remainder);
+
+// computes samples random discrete Morse functions of complex as SCMorseSpec does and counts the vectors of critical
+// faces. Whenever no face is free, a random face of the current dimension becomes critical. The samples are
+// distributed to threads workers, and every sample draws from its own RNG stream derived from seed.
+void morse_spectrum(const MovableComplex & complex, unsigned int samples, morse_order_t order, unsigned int threads, unsigned int seed, morse_spectrum_t & spectrum);
+
+#endif
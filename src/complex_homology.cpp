@@ -0,0 +1,325 @@
+//
+//  complex_homology.cpp
+//  Bistellar
+//
+
+#include "complex_homology.h"
+
+#include <algorithm>
+#include <climits>
+#include <unordered_map>
+#include <stdlib.h>
+
+// a column of a sparse integer matrix as (row, value) pairs sorted by row, without zero values
+typedef std::vector< std::pair< unsigned int, long long > > sparse_column_t;
+
+HomologyGroup::HomologyGroup() : free(0)
+{
+}
+
+std::ostream & operator<< (std::ostream & os, const HomologyGroup & group)
+{
+    os << "[" << group.free << ",[";
+    for (size_t i = 0; i < group.torsion.size(); i++)
+        os << (i > 0 ? "," : "") << group.torsion[i];
+    os << "]]";
+
+    return os;
+}
+
+// returns in result = a - factor*b, or false if it does not fit into a long long
+static bool subtractMultiple(long long a, long long factor, long long b, long long & result)
+{
+    long long product;
+    return !__builtin_mul_overflow(factor, b, &product) && !__builtin_sub_overflow(a, product, &result);
+}
+
+// sets target to target - factor*source and returns the rows new in target
+static bool subtractColumn(sparse_column_t & target, long long factor, const sparse_column_t & source, std::vector< unsigned int > & newRows)
+{
+    sparse_column_t result;
+    result.reserve(target.size() + source.size());
+
+    sparse_column_t::const_iterator it1 = target.begin();
+    sparse_column_t::const_iterator it2 = source.begin();
+    while (it1 != target.end() || it2 != source.end())
+    {
+        if (it2 == source.end() || (it1 != target.end() && it1->first < it2->first))
+        {
+            result.push_back(*it1++);
+        }
+        else if (it1 == target.end() || it2->first < it1->first)
+        {
+            long long value;
+            if (!subtractMultiple(0, factor, it2->second, value))
+                return false;
+            result.push_back(std::make_pair(it2->first, value));
+            newRows.push_back(it2->first);
+            it2++;
+        }
+        else
+        {
+            long long value;
+            if (!subtractMultiple(it1->second, factor, it2->second, value))
+                return false;
+            if (value != 0)
+                result.push_back(std::make_pair(it1->first, value));
+            it1++;
+            it2++;
+        }
+    }
+
+    target.swap(result);
+    return true;
+}
+
+// eliminates all entries +-1 of the matrix given by its columns, each together with its row and column, and returns
+// their number. Every elimination only adds multiples of columns to others, so the Smith normal form of the remaining
+// core differs from the one of the matrix just by the eliminated ones. Rows are chosen as short as possible to limit fill-in.
+static bool eliminateUnits(std::vector< sparse_column_t > & columns, unsigned int rows, unsigned int & eliminated)
+{
+    // the columns with an entry in each row. Entries of columns changed later may be outdated.
+    std::vector< std::vector< unsigned int > > rowColumns(rows);
+    for (unsigned int c = 0; c < columns.size(); c++)
+    {
+        for (sparse_column_t::const_iterator it = columns[c].begin(); it != columns[c].end(); it++)
+            rowColumns[it->first].push_back(c);
+    }
+
+    eliminated = 0;
+    bool eliminatedAny = true;
+    while (eliminatedAny)
+    {
+        eliminatedAny = false;
+        for (unsigned int c = 0; c < columns.size(); c++)
+        {
+            sparse_column_t::const_iterator pivot = columns[c].end();
+            for (sparse_column_t::const_iterator it = columns[c].begin(); it != columns[c].end(); it++)
+            {
+                if ((it->second == 1 || it->second == -1) && (pivot == columns[c].end() || rowColumns[it->first].size() < rowColumns[pivot->first].size()))
+                    pivot = it;
+            }
+            if (pivot == columns[c].end())
+                continue;
+
+            unsigned int row = pivot->first;
+            long long unit = pivot->second;
+            std::vector< unsigned int > newRows;
+            for (std::vector< unsigned int >::const_iterator it = rowColumns[row].begin(); it != rowColumns[row].end(); it++)
+            {
+                if (*it == c)
+                    continue;
+
+                sparse_column_t & target = columns[*it];
+                sparse_column_t::const_iterator entry = std::lower_bound(target.begin(), target.end(), std::make_pair(row, static_cast< long long >(LLONG_MIN)));
+                if (entry == target.end() || entry->first != row)
+                    continue;
+
+                newRows.clear();
+                if (!subtractColumn(target, entry->second * unit, columns[c], newRows))
+                    return false;
+                for (std::vector< unsigned int >::const_iterator rowIt = newRows.begin(); rowIt != newRows.end(); rowIt++)
+                    rowColumns[*rowIt].push_back(*it);
+            }
+
+            columns[c].clear();
+            rowColumns[row].clear();
+            eliminated++;
+            eliminatedAny = true;
+        }
+    }
+
+    return true;
+}
+
+// brings the dense matrix to Smith normal form and appends its nonzero diagonal entries to divisors
+static bool smithNormalForm(std::vector< std::vector< long long > > & matrix, std::vector< long long > & divisors)
+{
+    size_t rows = matrix.size();
+    size_t cols = rows > 0 ? matrix[0].size() : 0;
+
+    for (size_t t = 0; t < std::min(rows, cols); t++)
+    {
+        // move the entry of least absolute value to the pivot position
+        size_t pivotRow = rows, pivotCol = cols;
+        for (size_t i = t; i < rows; i++)
+        {
+            for (size_t j = t; j < cols; j++)
+            {
+                if (matrix[i][j] != 0 && (pivotRow == rows || llabs(matrix[i][j]) < llabs(matrix[pivotRow][pivotCol])))
+                {
+                    pivotRow = i;
+                    pivotCol = j;
+                }
+            }
+        }
+        if (pivotRow == rows)
+            break;
+
+        while (true)
+        {
+            matrix[t].swap(matrix[pivotRow]);
+            for (size_t i = 0; i < rows; i++)
+                std::swap(matrix[i][t], matrix[i][pivotCol]);
+
+            // clear the pivot column and row, remainders smaller than the pivot become the next pivot
+            bool cleared = true;
+            for (size_t i = t+1; i < rows; i++)
+            {
+                long long factor = matrix[i][t] / matrix[t][t];
+                for (size_t j = t; j < cols && factor != 0; j++)
+                {
+                    if (!subtractMultiple(matrix[i][j], factor, matrix[t][j], matrix[i][j]))
+                        return false;
+                }
+                if (matrix[i][t] != 0)
+                    cleared = false;
+            }
+            for (size_t j = t+1; j < cols; j++)
+            {
+                long long factor = matrix[t][j] / matrix[t][t];
+                for (size_t i = t; i < rows && factor != 0; i++)
+                {
+                    if (!subtractMultiple(matrix[i][j], factor, matrix[i][t], matrix[i][j]))
+                        return false;
+                }
+                if (matrix[t][j] != 0)
+                    cleared = false;
+            }
+
+            pivotRow = t;
+            pivotCol = t;
+            if (!cleared)
+            {
+                for (size_t i = t+1; i < rows; i++)
+                {
+                    if (matrix[i][t] != 0 && llabs(matrix[i][t]) < llabs(matrix[pivotRow][pivotCol]))
+                    {
+                        pivotRow = i;
+                        pivotCol = t;
+                    }
+                }
+                for (size_t j = t+1; j < cols; j++)
+                {
+                    if (matrix[t][j] != 0 && llabs(matrix[t][j]) < llabs(matrix[pivotRow][pivotCol]))
+                    {
+                        pivotRow = t;
+                        pivotCol = j;
+                    }
+                }
+                continue;
+            }
+
+            // the pivot has to divide the remaining entries, otherwise their row is added to the pivot row
+            size_t indivisibleRow = rows;
+            for (size_t i = t+1; i < rows && indivisibleRow == rows; i++)
+            {
+                for (size_t j = t+1; j < cols; j++)
+                {
+                    if (matrix[i][j] % matrix[t][t] != 0)
+                    {
+                        indivisibleRow = i;
+                        break;
+                    }
+                }
+            }
+            if (indivisibleRow == rows)
+                break;
+
+            for (size_t j = t; j < cols; j++)
+            {
+                if (__builtin_add_overflow(matrix[t][j], matrix[indivisibleRow][j], &matrix[t][j]))
+                    return false;
+            }
+        }
+
+        divisors.push_back(llabs(matrix[t][t]));
+    }
+
+    return true;
+}
+
+// computes the rank and the elementary divisors > 1 of the boundary operator from the faces of dimension d to those of dimension d-1
+static bool boundaryOperator(const MovableComplex & complex, unsigned int d, unsigned int & rank, std::vector< long long > & torsion)
+{
+    std::unordered_map< Face, unsigned int, FaceHash > rowIndices;
+    const face_set_t & boundaryFaces = complex.faces(d-1);
+    for (face_set_t::const_iterator it = boundaryFaces.begin(); it != boundaryFaces.end(); it++)
+        rowIndices.emplace(*it, static_cast< unsigned int >(rowIndices.size()));
+
+    // the i-th boundary face of a face with sorted vertices has sign (-1)^i
+    std::vector< sparse_column_t > columns;
+    const face_set_t & faces = complex.faces(d);
+    columns.reserve(faces.size());
+    for (face_set_t::const_iterator it = faces.begin(); it != faces.end(); it++)
+    {
+        sparse_column_t column;
+        for (unsigned int i = 0; i < d+1; i++)
+            column.push_back(std::make_pair(rowIndices[it->boundaryFace(i)], (i % 2 == 0) ? 1LL : -1LL));
+        std::sort(column.begin(), column.end());
+        columns.push_back(column);
+    }
+
+    if (!eliminateUnits(columns, static_cast< unsigned int >(rowIndices.size()), rank))
+        return false;
+
+    // the core consists of the remaining nonzero columns and the rows they use
+    std::vector< unsigned int > coreRows(rowIndices.size(), 0);
+    unsigned int numberOfCoreRows = 0;
+    std::vector< unsigned int > coreColumns;
+    for (unsigned int c = 0; c < columns.size(); c++)
+    {
+        if (columns[c].empty())
+            continue;
+        coreColumns.push_back(c);
+        for (sparse_column_t::const_iterator it = columns[c].begin(); it != columns[c].end(); it++)
+        {
+            if (coreRows[it->first] == 0)
+                coreRows[it->first] = ++numberOfCoreRows;
+        }
+    }
+    if (coreColumns.empty())
+        return true;
+
+    std::vector< std::vector< long long > > core(numberOfCoreRows, std::vector< long long >(coreColumns.size(), 0));
+    for (unsigned int j = 0; j < coreColumns.size(); j++)
+    {
+        const sparse_column_t & column = columns[coreColumns[j]];
+        for (sparse_column_t::const_iterator it = column.begin(); it != column.end(); it++)
+            core[coreRows[it->first]-1][j] = it->second;
+    }
+
+    std::vector< long long > divisors;
+    if (!smithNormalForm(core, divisors))
+        return false;
+
+    rank += static_cast< unsigned int >(divisors.size());
+    for (std::vector< long long >::const_iterator it = divisors.begin(); it != divisors.end(); it++)
+    {
+        if (*it > 1)
+            torsion.push_back(*it);
+    }
+    std::sort(torsion.begin(), torsion.end());
+
+    return true;
+}
+
+bool complex_homology(const MovableComplex & complex, homology_list_t & homology)
+{
+    unsigned int dimension = complex.dimension();
+    homology.assign(dimension+1, HomologyGroup());
+
+    // ranks[d] is the rank of the boundary operator of dimension d, the one of dimension 0 is the augmentation
+    std::vector< unsigned int > ranks(dimension+2, 0);
+    ranks[0] = complex.f(0) > 0 ? 1 : 0;
+    for (unsigned int d = 1; d < dimension+1; d++)
+    {
+        if (!boundaryOperator(complex, d, ranks[d], homology[d-1].torsion))
+            return false;
+    }
+
+    for (unsigned int d = 0; d < dimension+1; d++)
+        homology[d].free = complex.f(d) - ranks[d] - ranks[d+1];
+
+    return true;
+}
@@ -0,0 +1,33 @@
+//
+//  complex_homology.h
+//  Bistellar
+//
+
+#ifndef Bistellar_complex_homology_h
+#define Bistellar_complex_homology_h
+
+#include <iostream>
+#include <vector>
+#include "movable_complex.h"
+
+// a finitely generated abelian group Z^free + Z/t_1 + ... + Z/t_n with t_1 | t_2 | ... | t_n
+struct HomologyGroup
+{
+    unsigned int free;
+    std::vector< long long > torsion;
+
+    HomologyGroup();
+
+    // prints the group in the format [free,[t_1,...,t_n]] of SCHomology
+    friend std::ostream & operator<< (std::ostream & os, const HomologyGroup & group);
+};
+
+typedef std::vector< HomologyGroup > homology_list_t;
+
+// computes the reduced integral homology groups H_0, ..., H_d of complex as SCHomologyInternal does. The boundary
+// matrices are built sparsely from the faces of complex and reduced by pivoting on entries +-1, which keeps their
+// Smith normal form. The remaining core is brought to Smith normal form densely. Returns false if an entry of the
+// core exceeds the range of long long.
+bool complex_homology(const MovableComplex & complex, homology_list_t & homology);
+
+#endif
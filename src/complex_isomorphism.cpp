@@ -0,0 +1,368 @@
+//
+//  complex_isomorphism.cpp
+//  Bistellar
+//
+
+#include "complex_isomorphism.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+// a complex with its vertices numbered 0, ..., n-1
+struct IndexedComplex
+{
+    // the facets as sorted lists of vertex indices
+    std::vector< std::vector< unsigned int > > facets;
+    std::set< std::vector< unsigned int > > facetSet;
+    // the facets containing each vertex
+    std::vector< std::vector< unsigned int > > stars;
+};
+
+static void indexComplex(const face_set_t & facets, IndexedComplex & complex)
+{
+    std::map< vertex_t, unsigned int > indices;
+    for (face_set_t::const_iterator it = facets.begin(); it != facets.end(); it++)
+    {
+        for (int i = 0; i < it->dimension()+1; i++)
+            indices.insert(std::make_pair(it->vertex(i), 0));
+    }
+    unsigned int numberOfVertices = 0;
+    for (std::map< vertex_t, unsigned int >::iterator it = indices.begin(); it != indices.end(); it++)
+        it->second = numberOfVertices++;
+
+    complex.stars.resize(numberOfVertices);
+    for (face_set_t::const_iterator it = facets.begin(); it != facets.end(); it++)
+    {
+        std::vector< unsigned int > facet;
+        for (int i = 0; i < it->dimension()+1; i++)
+            facet.push_back(indices[it->vertex(i)]);
+        std::sort(facet.begin(), facet.end());
+
+        for (size_t i = 0; i < facet.size(); i++)
+            complex.stars[facet[i]].push_back(static_cast< unsigned int >(complex.facets.size()));
+        complex.facetSet.insert(facet);
+        complex.facets.push_back(facet);
+    }
+}
+
+// refines the colors of both complexes once, numbering the new colors consistently. Returns the number of colors.
+static size_t refineColors(const IndexedComplex & complex1, std::vector< unsigned int > & colors1, const IndexedComplex & complex2, std::vector< unsigned int > & colors2)
+{
+    // the new color of a vertex is given by its old color and the colors of the facets containing it
+    typedef std::pair< unsigned int, std::vector< std::vector< unsigned int > > > signature_t;
+    std::map< signature_t, unsigned int > newColors;
+
+    const IndexedComplex * complexes[2] = {&complex1, &complex2};
+    std::vector< unsigned int > * colors[2] = {&colors1, &colors2};
+    std::vector< unsigned int > refinedColors[2];
+    for (int c = 0; c < 2; c++)
+    {
+        const IndexedComplex & complex = *complexes[c];
+        const std::vector< unsigned int > & oldColors = *colors[c];
+        for (unsigned int v = 0; v < complex.stars.size(); v++)
+        {
+            signature_t signature(oldColors[v], std::vector< std::vector< unsigned int > >());
+            for (size_t i = 0; i < complex.stars[v].size(); i++)
+            {
+                const std::vector< unsigned int > & facet = complex.facets[complex.stars[v][i]];
+                std::vector< unsigned int > facetColors;
+                for (size_t j = 0; j < facet.size(); j++)
+                {
+                    if (facet[j] != v)
+                        facetColors.push_back(oldColors[facet[j]]);
+                }
+                std::sort(facetColors.begin(), facetColors.end());
+                signature.second.push_back(facetColors);
+            }
+            std::sort(signature.second.begin(), signature.second.end());
+
+            std::map< signature_t, unsigned int >::iterator it = newColors.insert(std::make_pair(signature, static_cast< unsigned int >(newColors.size()))).first;
+            refinedColors[c].push_back(it->second);
+        }
+    }
+
+    colors1.swap(refinedColors[0]);
+    colors2.swap(refinedColors[1]);
+    return newColors.size();
+}
+
+// refines the colors until they are stable. Returns false if some color occurs differently often in both complexes.
+static bool refine(const IndexedComplex & complex1, std::vector< unsigned int > & colors1, const IndexedComplex & complex2, std::vector< unsigned int > & colors2)
+{
+    std::set< unsigned int > distinctColors(colors1.begin(), colors1.end());
+    distinctColors.insert(colors2.begin(), colors2.end());
+    size_t numberOfColors = distinctColors.size();
+
+    while (true)
+    {
+        size_t newNumberOfColors = refineColors(complex1, colors1, complex2, colors2);
+
+        std::vector< unsigned int > sorted1(colors1), sorted2(colors2);
+        std::sort(sorted1.begin(), sorted1.end());
+        std::sort(sorted2.begin(), sorted2.end());
+        if (sorted1 != sorted2)
+            return false;
+
+        // refinement never merges colors, so it is stable once their number stays the same
+        if (newNumberOfColors == numberOfColors)
+            return true;
+        numberOfColors = newNumberOfColors;
+    }
+}
+
+// searches a color preserving isomorphism by individualization and refinement: a vertex of the smallest ambiguous
+// color class of complex1 is given a new color together with each candidate image in complex2 in turn, until all
+// classes are single vertices and the colors determine the bijection.
+static bool searchIsomorphism(const IndexedComplex & complex1, const std::vector< unsigned int > & colors1, const IndexedComplex & complex2, const std::vector< unsigned int > & colors2)
+{
+    unsigned int numberOfColors = *std::max_element(colors1.begin(), colors1.end()) + 1;
+    std::vector< unsigned int > classSizes(numberOfColors, 0);
+    for (size_t v = 0; v < colors1.size(); v++)
+        classSizes[colors1[v]]++;
+
+    unsigned int vertex = static_cast< unsigned int >(colors1.size());
+    for (unsigned int v = 0; v < colors1.size(); v++)
+    {
+        if (classSizes[colors1[v]] > 1 && (vertex == colors1.size() || classSizes[colors1[v]] < classSizes[colors1[vertex]]))
+            vertex = v;
+    }
+
+    if (vertex == colors1.size())
+    {
+        // the colors are a bijection, it is an isomorphism if it maps all facets onto facets
+        std::vector< unsigned int > image(numberOfColors);
+        for (unsigned int w = 0; w < colors2.size(); w++)
+            image[colors2[w]] = w;
+
+        for (size_t i = 0; i < complex1.facets.size(); i++)
+        {
+            std::vector< unsigned int > facetImage;
+            for (size_t j = 0; j < complex1.facets[i].size(); j++)
+                facetImage.push_back(image[colors1[complex1.facets[i][j]]]);
+            std::sort(facetImage.begin(), facetImage.end());
+            if (complex2.facetSet.find(facetImage) == complex2.facetSet.end())
+                return false;
+        }
+
+        return true;
+    }
+
+    for (unsigned int w = 0; w < colors2.size(); w++)
+    {
+        if (colors2[w] != colors1[vertex])
+            continue;
+
+        std::vector< unsigned int > individualized1(colors1), individualized2(colors2);
+        individualized1[vertex] = numberOfColors;
+        individualized2[w] = numberOfColors;
+        if (refine(complex1, individualized1, complex2, individualized2) && searchIsomorphism(complex1, individualized1, complex2, individualized2))
+            return true;
+    }
+
+    return false;
+}
+
+bool is_isomorphic(const face_set_t & facets1, const face_set_t & facets2)
+{
+    if (facets1.size() != facets2.size())
+        return false;
+    if (facets1.empty())
+        return true;
+    if (facets1.begin()->dimension() != facets2.begin()->dimension())
+        return false;
+
+    IndexedComplex complex1, complex2;
+    indexComplex(facets1, complex1);
+    indexComplex(facets2, complex2);
+    if (complex1.stars.size() != complex2.stars.size())
+        return false;
+
+    std::vector< unsigned int > colors1(complex1.stars.size(), 0), colors2(complex2.stars.size(), 0);
+    if (!refine(complex1, colors1, complex2, colors2))
+        return false;
+
+    return searchIsomorphism(complex1, colors1, complex2, colors2);
+}
+
+// appends a value in the encoding of SCExportIsoSig: values up to 63 are a single character, 0 being '.', larger
+// values are given by the number of their base 64 digits in decimal, followed by the digits
+static void appendSignatureValue(std::string & signature, unsigned int value)
+{
+    static const char digits[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ)!@#$%^&*(+.";
+    
+    if (value < 64)
+    {
+        signature += digits[(value + 63) % 64];
+        return;
+    }
+    
+    std::string encoded;
+    for (; value > 0; value /= 64)
+        encoded += digits[(value + 63) % 64];
+    signature += std::to_string(encoded.size());
+    signature.append(encoded.rbegin(), encoded.rend());
+}
+
+bool isomorphism_signature(const face_set_t & facets, std::string & signature)
+{
+    signature.clear();
+    if (facets.empty())
+    {
+        signature = ".";
+        return true;
+    }
+    
+    IndexedComplex complex;
+    indexComplex(facets, complex);
+    unsigned int numberOfFacets = static_cast< unsigned int >(complex.facets.size());
+    unsigned int size = static_cast< unsigned int >(complex.facets[0].size());
+    
+    // the facet across the ridge opposite to the i-th vertex of each facet, and the vertex of that facet not in the ridge
+    std::vector< std::vector< unsigned int > > neighbors(numberOfFacets, std::vector< unsigned int >(size));
+    std::vector< std::vector< unsigned int > > opposites(numberOfFacets, std::vector< unsigned int >(size));
+    std::map< std::vector< unsigned int >, std::vector< std::pair< unsigned int, unsigned int > > > ridges;
+    for (unsigned int f = 0; f < numberOfFacets; f++)
+    {
+        for (unsigned int i = 0; i < size; i++)
+        {
+            std::vector< unsigned int > ridge(complex.facets[f]);
+            ridge.erase(ridge.begin() + i);
+            ridges[ridge].push_back(std::make_pair(f, i));
+        }
+    }
+    for (std::map< std::vector< unsigned int >, std::vector< std::pair< unsigned int, unsigned int > > >::const_iterator it = ridges.begin(); it != ridges.end(); it++)
+    {
+        // every ridge of a closed pseudomanifold lies in exactly two facets
+        if (it->second.size() != 2)
+            return false;
+        
+        for (int j = 0; j < 2; j++)
+        {
+            std::pair< unsigned int, unsigned int > facet = it->second[j], other = it->second[1-j];
+            neighbors[facet.first][facet.second] = other.first;
+            opposites[facet.first][facet.second] = complex.facets[other.first][other.second];
+        }
+    }
+    
+    // the traversal below needs the complex to be strongly connected
+    std::vector< bool > discovered(numberOfFacets, false);
+    std::vector< unsigned int > queue(1, 0);
+    discovered[0] = true;
+    for (size_t current = 0; current < queue.size(); current++)
+    {
+        for (unsigned int i = 0; i < size; i++)
+        {
+            if (!discovered[neighbors[queue[current]][i]])
+            {
+                discovered[neighbors[queue[current]][i]] = true;
+                queue.push_back(neighbors[queue[current]][i]);
+            }
+        }
+    }
+    if (queue.size() < numberOfFacets)
+        return false;
+    
+    // Starting from every facet with every labeling of its vertices by 1, ..., size, the facets are traversed
+    // breadth first. Each facet visits its ridges in the order of the labels of the opposite vertices, and for each
+    // ridge the sequence records 0 if the facet across was already discovered, else the label of its new vertex,
+    // labeling vertices in the order they are met. The signature encodes the lexicographically least sequence.
+    std::vector< unsigned int > labels(complex.stars.size(), 0);
+    std::vector< unsigned int > labeledVertices;
+    std::vector< unsigned int > best, sequence;
+    for (unsigned int start = 0; start < numberOfFacets; start++)
+    {
+        std::vector< unsigned int > order(size);
+        for (unsigned int i = 0; i < size; i++)
+            order[i] = i;
+        
+        do {
+            for (size_t i = 0; i < labeledVertices.size(); i++)
+                labels[labeledVertices[i]] = 0;
+            labeledVertices.clear();
+            for (size_t i = 0; i < queue.size(); i++)
+                discovered[queue[i]] = false;
+            queue.assign(1, start);
+            discovered[start] = true;
+            
+            for (unsigned int i = 0; i < size; i++)
+            {
+                labels[complex.facets[start][order[i]]] = i + 1;
+                labeledVertices.push_back(complex.facets[start][order[i]]);
+            }
+            unsigned int numberOfLabels = size;
+            
+            sequence.clear();
+            // whether the sequence is already known to be smaller than best
+            bool smaller = best.empty();
+            bool abandoned = false;
+            
+            for (size_t current = 0; queue.size() < numberOfFacets && !abandoned; current++)
+            {
+                const std::vector< unsigned int > & facet = complex.facets[queue[current]];
+                std::vector< std::pair< unsigned int, unsigned int > > labeledPositions;
+                for (unsigned int i = 0; i < size; i++)
+                    labeledPositions.push_back(std::make_pair(labels[facet[i]], i));
+                std::sort(labeledPositions.begin(), labeledPositions.end());
+                
+                for (unsigned int i = 0; i < size; i++)
+                {
+                    unsigned int position = labeledPositions[i].second;
+                    unsigned int neighbor = neighbors[queue[current]][position];
+                    unsigned int value = 0;
+                    if (!discovered[neighbor])
+                    {
+                        discovered[neighbor] = true;
+                        queue.push_back(neighbor);
+                        
+                        unsigned int vertex = opposites[queue[current]][position];
+                        if (labels[vertex] == 0)
+                        {
+                            labels[vertex] = ++numberOfLabels;
+                            labeledVertices.push_back(vertex);
+                        }
+                        value = labels[vertex];
+                    }
+                    
+                    if (!smaller)
+                    {
+                        if (sequence.size() >= best.size() || value > best[sequence.size()])
+                        {
+                            abandoned = true;
+                            break;
+                        }
+                        if (value < best[sequence.size()])
+                            smaller = true;
+                    }
+                    sequence.push_back(value);
+                }
+            }
+            
+            if (!abandoned && (smaller || sequence.size() < best.size()))
+                best.swap(sequence);
+        } while (std::next_permutation(order.begin(), order.end()));
+    }
+    
+    appendSignatureValue(signature, size);
+    // the ridges of the first facet are never skipped
+    for (unsigned int i = 0; i < size; i++)
+        appendSignatureValue(signature, best[i]);
+    // the others are given as the number of skipped ridges followed by the next value, trailing skips are omitted
+    unsigned int skipped = 0;
+    for (size_t i = size; i < best.size(); i++)
+    {
+        if (best[i] == 0)
+        {
+            skipped++;
+        }
+        else
+        {
+            appendSignatureValue(signature, skipped);
+            appendSignatureValue(signature, best[i]);
+            skipped = 0;
+        }
+    }
+    
+    return true;
+}
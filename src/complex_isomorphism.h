@@ -0,0 +1,23 @@
+//
+//  complex_isomorphism.h
+//  Bistellar
+//
+
+#ifndef Bistellar_complex_isomorphism_h
+#define Bistellar_complex_isomorphism_h
+
+#include <string>
+#include "types.h"
+#include "face.h"
+
+// tests if the complexes given by their facets are combinatorially isomorphic, i.e. if a bijection of their
+// vertices maps the facets of the first onto the facets of the second. The vertices are partitioned by color
+// refinement on the vertex-facet incidences, and ambiguous colors are resolved by individualizing single vertices.
+bool is_isomorphic(const face_set_t & facets1, const face_set_t & facets2);
+
+// computes the isomorphism signature of a closed, strongly connected pseudomanifold given by its facets, in the format
+// of SCExportIsoSig and SCFromIsoSig (lib/isosig.gi). Isomorphic complexes have the same signature. Returns false if
+// the complex is not a closed, strongly connected pseudomanifold.
+bool isomorphism_signature(const face_set_t & facets, std::string & signature);
+
+#endif
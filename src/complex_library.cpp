@@ -0,0 +1,376 @@
+//
+//  complex_library.cpp
+//  Bistellar
+//
+
+#include "complex_library.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <dirent.h>
+#include <sys/stat.h>
+
+static const char libraryMagic[4] = {'S', 'C', 'S', 'C'};
+
+// pickled values are skipped recursively up to this depth, deeper ones are taken as malformed
+static const unsigned int maximalPickleDepth = 64;
+
+// reads the tag of a pickled value from it and advances it if it equals tag
+static bool readTag(const char *& it, const char * last, const char * tag)
+{
+    if (last - it < 4 || std::memcmp(it, tag, 4) != 0)
+        return false;
+
+    it += 4;
+    return true;
+}
+
+// reads length characters from it as hexadecimal integer with an optional sign, as written by HexStringInt
+static bool readHex(const char *& it, const char * last, size_t length, long long & value)
+{
+    if (length == 0 || static_cast< size_t >(last - it) < length)
+        return false;
+
+    const char * end = it + length;
+    bool negative = (*it == '-');
+    if (negative && ++it == end)
+        return false;
+
+    unsigned long long magnitude = 0;
+    for (; it != end; it++)
+    {
+        unsigned int digit;
+        if (*it >= '0' && *it <= '9')
+            digit = *it - '0';
+        else if (*it >= 'A' && *it <= 'F')
+            digit = *it - 'A' + 10;
+        else
+            return false;
+
+        if (magnitude > static_cast< unsigned long long >(std::numeric_limits< long long >::max()) >> 4)
+            return false;
+        magnitude = (magnitude << 4) | digit;
+    }
+    value = negative ? -static_cast< long long >(magnitude) : static_cast< long long >(magnitude);
+
+    return true;
+}
+
+// reads a small integer as written by IO_WriteSmallInt: the number of its hexadecimal digits as byte, then the digits
+static bool readSmallInt(const char *& it, const char * last, long long & value)
+{
+    if (it == last)
+        return false;
+
+    size_t length = static_cast< unsigned char >(*it++);
+    return readHex(it, last, length, value);
+}
+
+// reads a pickled integer, i.e. "INTG", the number of its hexadecimal digits as small integer, then the digits
+static bool readInteger(const char *& it, const char * last, long long & value)
+{
+    long long length;
+    return readTag(it, last, "INTG") && readSmallInt(it, last, length) && length > 0 && readHex(it, last, static_cast< size_t >(length), value);
+}
+
+// reads a pickled string, mutable or not, i.e. its tag, its length as small integer, then its characters
+static bool readString(const char *& it, const char * last, std::string & value)
+{
+    long long length;
+    if (!(readTag(it, last, "MSTR") || readTag(it, last, "ISTR")) || !readSmallInt(it, last, length))
+        return false;
+    if (length < 0 || length > last - it)
+        return false;
+
+    value.assign(it, static_cast< size_t >(length));
+    it += length;
+
+    return true;
+}
+
+// reads a pickled list of integers, either as list, mutable or not, or as range [first,second..last]
+static bool readIntegers(const char *& it, const char * last, std::vector< long long > & values)
+{
+    values.clear();
+    long long length;
+    if (readTag(it, last, "IRNG") || readTag(it, last, "MRNG"))
+    {
+        long long first, second, end;
+        if (!readSmallInt(it, last, first) || !readSmallInt(it, last, second) || !readSmallInt(it, last, end))
+            return false;
+        if (second <= first || end < first)
+            return false;
+
+        for (long long value = first; value <= end; value += second - first)
+            values.push_back(value);
+
+        return true;
+    }
+    if (!(readTag(it, last, "ILIS") || readTag(it, last, "MLIS")) || !readSmallInt(it, last, length) || length < 0)
+        return false;
+
+    for (long long i = 0; i < length; i++)
+    {
+        long long value;
+        if (!readInteger(it, last, value))
+            return false;
+        values.push_back(value);
+    }
+
+    return true;
+}
+
+// skips a pickled value of any type occurring in the library
+static bool skipValue(const char *& it, const char * last, unsigned int depth)
+{
+    if (depth > maximalPickleDepth || last - it < 4)
+        return false;
+
+    long long length, value;
+    std::string tag(it, 4);
+    it += 4;
+    if (tag == "INTG")
+    {
+        return readSmallInt(it, last, length) && length > 0 && length <= last - it && (it += length, true);
+    }
+    else if (tag == "MSTR" || tag == "ISTR")
+    {
+        return readSmallInt(it, last, length) && length >= 0 && length <= last - it && (it += length, true);
+    }
+    else if (tag == "ILIS" || tag == "MLIS")
+    {
+        if (!readSmallInt(it, last, length) || length < 0)
+            return false;
+        for (long long i = 0; i < length; i++)
+        {
+            if (!skipValue(it, last, depth+1))
+                return false;
+        }
+        return true;
+    }
+    else if (tag == "IRNG" || tag == "MRNG")
+    {
+        return readSmallInt(it, last, value) && readSmallInt(it, last, value) && readSmallInt(it, last, value);
+    }
+    else if (tag == "MREC" || tag == "IREC" || tag == "SCSC")
+    {
+        if (!readSmallInt(it, last, length) || length < 0)
+            return false;
+        for (long long i = 0; i < 2*length; i++)
+        {
+            if (!skipValue(it, last, depth+1))
+                return false;
+        }
+        return true;
+    }
+    else if (tag == "SREF")
+    {
+        return readSmallInt(it, last, value);
+    }
+
+    return tag == "TRUE" || tag == "FALS" || tag == "FAIL";
+}
+
+// sets error to message at the offset of position and returns false
+static bool libraryError(const char * begin, const char * position, const char * message, std::string & error)
+{
+    std::ostringstream os;
+    os << message << " at offset " << (position - begin);
+    error = os.str();
+
+    return false;
+}
+
+bool is_library_complex(const char * first, const char * last)
+{
+    return last - first >= static_cast< std::ptrdiff_t >(sizeof(libraryMagic)) && std::equal(libraryMagic, libraryMagic + sizeof(libraryMagic), first);
+}
+
+bool decode_library_complex(const char * first, const char * last, face_list_t & facets, std::string & error)
+{
+    const char * it = first;
+    long long attributes;
+    if (!readTag(it, last, "SCSC") || !readSmallInt(it, last, attributes))
+        return libraryError(first, it, "expected a pickled complex", error);
+
+    // the number of attributes written by SCIntFunc.GeneralPickler includes those it ignores, so the data may end early
+    for (long long i = 0; i < attributes && it != last; i++)
+    {
+        std::string name;
+        if (!readString(it, last, name))
+            return libraryError(first, it, "expected an attribute name", error);
+
+        if (name != "SCFacetsEx")
+        {
+            if (!skipValue(it, last, 0))
+                return libraryError(first, it, "malformed value of attribute", error);
+            continue;
+        }
+
+        const char * listStart = it;
+        long long length;
+        if (!(readTag(it, last, "ILIS") || readTag(it, last, "MLIS")) || !readSmallInt(it, last, length) || length <= 0)
+            return libraryError(first, listStart, "expected a list of facets", error);
+
+        std::vector< long long > values;
+        std::vector< vertex_t > vertices;
+        for (long long j = 0; j < length; j++)
+        {
+            const char * facetStart = it;
+            if (!readIntegers(it, last, values) || values.empty())
+                return libraryError(first, facetStart, "expected a facet", error);
+            if (!facets.empty() && static_cast< int >(values.size()) - 1 != facets.front().dimension())
+                return libraryError(first, facetStart, "facet of different dimension", error);
+
+            vertices.clear();
+            for (std::vector< long long >::const_iterator value = values.begin(); value != values.end(); value++)
+            {
+                if (*value < 0 || static_cast< unsigned long long >(*value) > std::numeric_limits< vertex_t >::max())
+                    return libraryError(first, facetStart, "vertex out of range", error);
+                vertices.push_back(static_cast< vertex_t >(*value));
+            }
+            facets.emplace_back(vertices.data(), static_cast< int >(vertices.size()) - 1);
+        }
+
+        return true;
+    }
+
+    return libraryError(first, it, "no attribute SCFacetsEx", error);
+}
+
+// collects the files *.scb below directory path into files, returns false if path is no readable directory
+static bool listDirectory(const std::string & path, std::vector< std::string > & files)
+{
+    DIR * directory = opendir(path.c_str());
+    if (directory == 0)
+        return false;
+
+    std::vector< std::string > subdirectories;
+    while (dirent * entry = readdir(directory))
+    {
+        std::string name(entry->d_name);
+        if (name == "." || name == "..")
+            continue;
+
+        std::string child = (path[path.size()-1] == '/') ? path + name : path + "/" + name;
+        struct stat status;
+        if (stat(child.c_str(), &status) != 0)
+            continue;
+
+        if (S_ISDIR(status.st_mode))
+            subdirectories.push_back(child);
+        else if (name.size() > 4 && name.compare(name.size() - 4, 4, ".scb") == 0)
+            files.push_back(child);
+    }
+    closedir(directory);
+
+    for (std::vector< std::string >::const_iterator it = subdirectories.begin(); it != subdirectories.end(); it++)
+        listDirectory(*it, files);
+
+    return true;
+}
+
+// collects the files named by the index file path of SCLibInit, a pickled SCLibRepository whose record of properties
+// has the list Index of records with the entry File
+static bool listIndex(const std::string & path, std::vector< std::string > & files, std::string & error)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file)
+    {
+        error = "could not read " + path;
+        return false;
+    }
+    std::string data((std::istreambuf_iterator< char >(file)), std::istreambuf_iterator< char >());
+
+    std::string::size_type slash = path.find_last_of('/');
+    std::string directory = (slash == std::string::npos) ? std::string(".") : path.substr(0, slash);
+
+    const char * first = data.data();
+    const char * last = first + data.size();
+    const char * it = first;
+    long long properties;
+    if (!readTag(it, last, "SCLR") || !readTag(it, last, "MREC") || !readSmallInt(it, last, properties))
+        return libraryError(first, it, "expected a pickled library repository", error);
+
+    for (long long i = 0; i < properties; i++)
+    {
+        std::string name;
+        if (!readString(it, last, name))
+            return libraryError(first, it, "expected a property name", error);
+
+        if (name != "Index")
+        {
+            if (!skipValue(it, last, 0))
+                return libraryError(first, it, "malformed value of property", error);
+            continue;
+        }
+
+        long long entries;
+        if (!(readTag(it, last, "ILIS") || readTag(it, last, "MLIS")) || !readSmallInt(it, last, entries))
+            return libraryError(first, it, "expected a list of entries", error);
+
+        for (long long j = 0; j < entries; j++)
+        {
+            long long fields;
+            if (!(readTag(it, last, "MREC") || readTag(it, last, "IREC")) || !readSmallInt(it, last, fields))
+                return libraryError(first, it, "expected an entry", error);
+
+            for (long long k = 0; k < fields; k++)
+            {
+                std::string field, value;
+                if (!readString(it, last, field))
+                    return libraryError(first, it, "expected a field name", error);
+
+                if (field != "File")
+                {
+                    if (!skipValue(it, last, 0))
+                        return libraryError(first, it, "malformed value of field", error);
+                }
+                else if (readString(it, last, value))
+                {
+                    files.push_back(directory + "/" + value);
+                }
+                else
+                {
+                    return libraryError(first, it, "expected a file name", error);
+                }
+            }
+        }
+
+        return true;
+    }
+
+    return libraryError(first, it, "no property Index", error);
+}
+
+bool list_library(const std::string & path, std::vector< std::string > & files, std::string & error)
+{
+    files.clear();
+
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0)
+    {
+        error = "could not find " + path;
+        return false;
+    }
+
+    if (S_ISDIR(status.st_mode))
+    {
+        if (!listDirectory(path, files))
+        {
+            error = "could not read " + path;
+            return false;
+        }
+    }
+    else if (!listIndex(path, files, error))
+    {
+        return false;
+    }
+    std::sort(files.begin(), files.end());
+
+    return true;
+}
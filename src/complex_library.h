@@ -0,0 +1,31 @@
+//
+//  complex_library.h
+//  Bistellar
+//
+
+#ifndef Bistellar_complex_library_h
+#define Bistellar_complex_library_h
+
+#include <string>
+#include <vector>
+#include "types.h"
+#include "face.h"
+
+// Complexes of the simpcomp library (complexes/*.scb) are stored by SCSave through IO_Pickle (lib/io.gi): the tag
+// "SCSC", the number of attributes and pairs of attribute name and value. Values are tagged as well, e.g. "INTG" for
+// integers, "ILIS" for lists and "MSTR" for strings, with lengths and integers in hexadecimal.
+
+// tests if the characters [first, last) start with a complex pickled by SCSave
+bool is_library_complex(const char * first, const char * last);
+
+// decodes the facets of a complex pickled by SCSave from [first, last), given by its attribute SCFacetsEx, into
+// facets. Returns false if the data is malformed or has no facets, in which case error describes the problem and its
+// offset from first.
+bool decode_library_complex(const char * first, const char * last, face_list_t & facets, std::string & error);
+
+// lists the complexes of a library, given either as directory, which is searched recursively for files *.scb, or as
+// index file complexes.idxb of SCLibInit, whose entries name files relative to its directory. files receives the
+// paths in lexicographic order. Returns false and sets error if the directory or index cannot be read.
+bool list_library(const std::string & path, std::vector< std::string > & files, std::string & error);
+
+#endif
@@ -0,0 +1,68 @@
+//
+//  complex_memory.cpp
+//  Bistellar
+//
+
+#include "complex_memory.h"
+
+// initial size of the scratch buffer. Larger moves continue in blocks taken from the pool.
+static const std::size_t scratchBufferSize = 64 * 1024;
+
+OverflowResource::OverflowResource(std::pmr::memory_resource * upstream) : _upstream(upstream), _bytes(0)
+{
+}
+
+void * OverflowResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    _bytes += bytes;
+    return _upstream->allocate(bytes, alignment);
+}
+
+void OverflowResource::do_deallocate(void * p, std::size_t bytes, std::size_t alignment)
+{
+    _upstream->deallocate(p, bytes, alignment);
+}
+
+bool OverflowResource::do_is_equal(const std::pmr::memory_resource & other) const noexcept
+{
+    return this == &other;
+}
+
+std::size_t OverflowResource::bytes() const
+{
+    return _bytes;
+}
+
+void OverflowResource::reset()
+{
+    _bytes = 0;
+}
+
+ComplexMemory::ComplexMemory() : _pool(), _overflow(&_pool), _scratchBuffer(scratchBufferSize), _scratch(new std::pmr::monotonic_buffer_resource(&_scratchBuffer[0], _scratchBuffer.size(), &_overflow))
+{
+}
+
+std::pmr::memory_resource * ComplexMemory::pool()
+{
+    return &_pool;
+}
+
+std::pmr::memory_resource * ComplexMemory::scratch()
+{
+    return _scratch.get();
+}
+
+void ComplexMemory::releaseScratch()
+{
+    _scratch->release();
+    if (_overflow.bytes() == 0)
+        return;
+
+    // blocks this large bypass the pools and go to the heap and back on every move, so the buffer grows to take
+    // them in. Doubling keeps the number of regrowths logarithmic in the size of the largest move.
+    std::size_t size = 2 * (_scratchBuffer.size() + _overflow.bytes());
+    _scratch.reset();
+    _scratchBuffer.assign(size, 0);
+    _scratch.reset(new std::pmr::monotonic_buffer_resource(&_scratchBuffer[0], _scratchBuffer.size(), &_overflow));
+    _overflow.reset();
+}
@@ -0,0 +1,107 @@
+//
+//  complex_memory.h
+//  Bistellar
+//
+
+#ifndef Bistellar_complex_memory_h
+#define Bistellar_complex_memory_h
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+// STL allocator drawing its memory from a memory resource, by default from the global heap.
+// Unlike std::pmr::polymorphic_allocator it moves and swaps along with its container, so a
+// container can be moved or swapped together with the resource that owns its memory.
+template< class T >
+class ResourceAllocator
+{
+    template< class U > friend class ResourceAllocator;
+
+    std::pmr::memory_resource * _resource;
+
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    ResourceAllocator() : _resource(std::pmr::new_delete_resource()) {}
+    ResourceAllocator(std::pmr::memory_resource * resource) : _resource(resource) {}
+    template< class U > ResourceAllocator(const ResourceAllocator< U > & other) : _resource(other._resource) {}
+
+    T * allocate(std::size_t n)
+    {
+        return static_cast< T * >(_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T * p, std::size_t n)
+    {
+        _resource->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    // copies of containers do not share the resource of the original, they use the global heap.
+    ResourceAllocator select_on_container_copy_construction() const
+    {
+        return ResourceAllocator();
+    }
+
+    std::pmr::memory_resource * resource() const
+    {
+        return _resource;
+    }
+
+    template< class U > bool operator==(const ResourceAllocator< U > & other) const
+    {
+        return _resource == other._resource;
+    }
+    template< class U > bool operator!=(const ResourceAllocator< U > & other) const
+    {
+        return _resource != other._resource;
+    }
+};
+
+// memory resource passing its allocations on to another one and counting the bytes allocated
+class OverflowResource : public std::pmr::memory_resource
+{
+    std::pmr::memory_resource * _upstream;
+    std::size_t _bytes;
+
+    void * do_allocate(std::size_t bytes, std::size_t alignment);
+    void do_deallocate(void * p, std::size_t bytes, std::size_t alignment);
+    bool do_is_equal(const std::pmr::memory_resource & other) const noexcept;
+
+public:
+    OverflowResource(std::pmr::memory_resource * upstream);
+
+    // the number of bytes allocated since the last reset
+    std::size_t bytes() const;
+    void reset();
+};
+
+// The memory of a MovableComplex: a pool recycling the nodes of the persistent face and move
+// containers, and a scratch arena for the temporary lists of a single move, which is released
+// in bulk once the move is done. Neither is synchronized, a complex is used by one thread at a time.
+class ComplexMemory
+{
+    std::pmr::unsynchronized_pool_resource _pool;
+    // blocks of a move exceeding the scratch buffer, taken from the pool
+    OverflowResource _overflow;
+    std::vector< char > _scratchBuffer;
+    std::unique_ptr< std::pmr::monotonic_buffer_resource > _scratch;
+
+    ComplexMemory(const ComplexMemory &);
+    ComplexMemory & operator=(const ComplexMemory &);
+
+public:
+    ComplexMemory();
+
+    std::pmr::memory_resource * pool();
+    std::pmr::memory_resource * scratch();
+
+    // frees everything allocated from the scratch arena. No scratch allocation may be in use. If the last move
+    // exceeded the scratch buffer, the buffer grows to hold it, so that moves of its size need no further blocks.
+    void releaseScratch();
+};
+
+#endif
@@ -0,0 +1,58 @@
+//
+//  complex_sessions.cpp
+//  Bistellar
+//
+
+#include "complex_sessions.h"
+
+#include <cctype>
+#include "facet_parser.h"
+
+ComplexSessions::ComplexSessions() : _nextHandle(1)
+{
+}
+
+unsigned int ComplexSessions::load(MovableComplex && complex)
+{
+    unsigned int handle = _nextHandle++;
+    _complexes[handle] = std::move(complex);
+
+    return handle;
+}
+
+MovableComplex * ComplexSessions::find(unsigned int handle)
+{
+    std::map< unsigned int, MovableComplex >::iterator it = _complexes.find(handle);
+    if (it == _complexes.end())
+        return 0;
+
+    return &it->second;
+}
+
+bool ComplexSessions::free(unsigned int handle)
+{
+    return _complexes.erase(handle) != 0;
+}
+
+MovableComplex * ComplexSessions::read(const std::string & line, std::istream & is, std::istream & input, MovableComplex & parsed, unsigned int & handle, std::string & error)
+{
+    is >> std::ws;
+    if (std::isdigit(is.peek()))
+    {
+        is >> handle;
+        MovableComplex * complex = find(handle);
+        if (complex == 0)
+            error = "unknown handle " + std::to_string(handle);
+
+        return complex;
+    }
+
+    handle = 0;
+    if (!read_complex(line, is, input, parsed, error))
+    {
+        error = "malformed complex: " + error;
+        return 0;
+    }
+
+    return &parsed;
+}
@@ -0,0 +1,37 @@
+//
+//  complex_sessions.h
+//  Bistellar
+//
+
+#ifndef Bistellar_complex_sessions_h
+#define Bistellar_complex_sessions_h
+
+#include <iostream>
+#include <map>
+#include <string>
+#include "movable_complex.h"
+
+// The complexes loaded into a session, addressed by the handles 1, 2, ... A loaded complex keeps its faces and
+// move tables until it is freed, so commands on its handle neither parse nor rebuild it.
+class ComplexSessions
+{
+    std::map< unsigned int, MovableComplex > _complexes;
+    unsigned int _nextHandle;
+
+public:
+    ComplexSessions();
+
+    // takes over complex and returns its new handle
+    unsigned int load(MovableComplex && complex);
+    // returns the complex of handle, or 0 if there is none
+    MovableComplex * find(unsigned int handle);
+    // removes the complex of handle. Returns false if there is none.
+    bool free(unsigned int handle);
+
+    // reads either a handle or a complex as read by read_complex from line, starting at the position of is, which must
+    // be a stream over line. Such a complex is stored in parsed. Sets handle to the handle read, or to 0 otherwise, and
+    // returns the complex to work on, or 0 and sets error if the handle is unknown or the complex malformed.
+    MovableComplex * read(const std::string & line, std::istream & is, std::istream & input, MovableComplex & parsed, unsigned int & handle, std::string & error);
+};
+
+#endif
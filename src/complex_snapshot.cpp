@@ -0,0 +1,31 @@
+//
+//  complex_snapshot.cpp
+//  Bistellar
+//
+
+#include "complex_snapshot.h"
+#include "util.h"
+
+ComplexSnapshot::ComplexSnapshot() : _dimension(0), _journalId(0)
+{
+}
+
+unsigned int ComplexSnapshot::dimension() const
+{
+    return _dimension;
+}
+
+const face_set_t & ComplexSnapshot::facets() const
+{
+    return _facets;
+}
+
+// serialization methods
+std::ostream & operator<< (std::ostream & os, const ComplexSnapshot & snapshot)
+{
+    // the facets are formatted into one buffer and written in one go
+    std::string & buffer = output_buffer();
+    write_list(buffer, snapshot._facets.begin(), snapshot._facets.end());
+    os.write(buffer.data(), buffer.size());
+    return os;
+}
@@ -0,0 +1,36 @@
+//
+//  complex_snapshot.h
+//  Bistellar
+//
+
+#ifndef Bistellar_complex_snapshot_h
+#define Bistellar_complex_snapshot_h
+
+class ComplexSnapshot;
+
+#include <iostream>
+#include "types.h"
+#include "face.h"
+
+// The facets of a MovableComplex at some point of time. A snapshot is taken with MovableComplex::snapshot,
+// taking it again from the same complex only applies the facets changed since, see there.
+class ComplexSnapshot
+{
+    friend class MovableComplex;
+    
+    unsigned int _dimension;
+    face_set_t _facets;
+    // journal id of the complex the snapshot is in sync with, 0 if none
+    unsigned long long _journalId;
+    
+public:
+    ComplexSnapshot();
+    
+    unsigned int dimension() const;
+    const face_set_t & facets() const;
+    
+    // serialization methods
+    friend std::ostream & operator<< (std::ostream & os, const ComplexSnapshot & snapshot);
+};
+
+#endif
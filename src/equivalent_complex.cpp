@@ -0,0 +1,69 @@
+//
+//  equivalent_complex.cpp
+//  Bistellar
+//
+
+#include "equivalent_complex.h"
+
+#include <iostream>
+#include "complex_isomorphism.h"
+#include "reduce_complex.h"
+
+static int eulerCharacteristic(const MovableComplex & complex)
+{
+    int characteristic = 0;
+    for (unsigned int d = 0; d < complex.dimension()+1; d++)
+        characteristic += (d % 2 == 0) ? static_cast< int >(complex.f(d)) : -static_cast< int >(complex.f(d));
+
+    return characteristic;
+}
+
+static bool sameFVector(const MovableComplex & complex1, const MovableComplex & complex2)
+{
+    for (unsigned int d = 0; d < complex1.dimension()+1; d++)
+    {
+        if (complex1.f(d) != complex2.f(d))
+            return false;
+    }
+
+    return true;
+}
+
+equivalence_t equivalent_complex(MovableComplex & complex, const MovableComplex & reference, unsigned int rounds, const ReductionSchedule & schedule, int heating, int relaxation, unsigned int seed, MoveTrace * trace)
+{
+    // both are invariant under bistellar moves
+    if (complex.dimension() != reference.dimension() || eulerCharacteristic(complex) != eulerCharacteristic(reference))
+        return equivalence_false;
+
+    std::seed_seq seeds = {seed, 0u};
+    random_engine_t rng(seeds);
+    unsigned int minimalVertices = complex.f(0);
+
+    for (unsigned int currentRound = 0; currentRound < rounds; currentRound++)
+    {
+        if (currentRound > 0)
+        {
+            codimension_list_t moves;
+            schedule.selectCodimensions(complex, heating, relaxation, moves);
+            if (numberOfValidMoves(complex, moves) == 0)
+                break;
+
+            BistellarMove move = randomValidMove(complex, moves, rng);
+            if (trace != 0)
+                trace->record(complex.resolvedMove(move));
+            complex.moveComplex(move);
+
+            if (complex.f(0) < minimalVertices)
+            {
+                minimalVertices = complex.f(0);
+                std::cout << "found complex with " << minimalVertices << " vertices in round " << currentRound << std::endl;
+            }
+        }
+
+        // the facets are only read, so neither complex starts journaling
+        if (sameFVector(complex, reference) && is_isomorphic(complex.faces(complex.dimension()), reference.faces(reference.dimension())))
+            return equivalence_true;
+    }
+
+    return equivalence_unknown;
+}
@@ -0,0 +1,28 @@
+//
+//  equivalent_complex.h
+//  Bistellar
+//
+
+#ifndef Bistellar_equivalent_complex_h
+#define Bistellar_equivalent_complex_h
+
+#include "movable_complex.h"
+#include "move_trace.h"
+#include "reduction_schedule.h"
+
+// result of an equivalence test. Bistellar equivalence is undecidable in general, so a search may end without an answer.
+enum equivalence_t
+{
+    equivalence_unknown,
+    equivalence_true,
+    equivalence_false
+};
+
+// searches a sequence of bistellar moves transforming complex into a complex combinatorially isomorphic to reference.
+// The moves are chosen as by reduce_complex with the given schedule, and after each move whose f-vector matches the
+// one of reference the complexes are tested for isomorphism. Returns equivalence_false if the dimensions or Euler
+// characteristics differ and equivalence_unknown if no isomorphic complex was found within rounds moves.
+// complex is left at the last complex visited. If trace is given, it receives the moves applied.
+equivalence_t equivalent_complex(MovableComplex & complex, const MovableComplex & reference, unsigned int rounds, const ReductionSchedule & schedule, int heating, int relaxation, unsigned int seed, MoveTrace * trace = 0);
+
+#endif
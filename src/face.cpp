@@ -11,42 +11,53 @@
 #include <vector>
 #include <string.h>
 #include <stdlib.h>
+#include <algorithm>
 #include "util.h"
 
+const unsigned int maskBits = 64 * Bistellar_vertex_mask_words;
 
-Face::Face() : _vertices(0), _dimension(-1)
+
+Face::Face() : _heapVertices(0), _dimension(-1)
 {
-    
+    updateMask();
 }
 
-Face::Face(const vertex_t * vertices, int dimension) : _vertices(0), _dimension(dimension)
+Face::Face(const vertex_t * vertices, int dimension) : _heapVertices(0), _dimension(-1)
 {
-    if (_dimension < 0)
-    {
-        _dimension = -1;
-    }
-    else
+    if (dimension >= 0)
     {
-        _vertices = new vertex_t[dimension+1];
-        memcpy(_vertices, vertices, (dimension+1)*sizeof(vertex_t));
-        qsort(_vertices, dimension+1, sizeof(vertex_t), vertex_t_compare);
+        vertex_t * ownVertices = allocate(dimension);
+        memcpy(ownVertices, vertices, (dimension+1)*sizeof(vertex_t));
+        std::sort(ownVertices, ownVertices + dimension+1);
     }
+    updateMask();
 }
 
-Face::Face(const Face & cpy) : _vertices(0), _dimension(cpy._dimension)
+Face::Face(const Face & cpy) : _heapVertices(0), _dimension(-1)
 {
-    if (cpy._vertices != 0)
-    {
-        _vertices = new vertex_t[cpy._dimension+1];
-        memcpy(_vertices, cpy._vertices, (cpy._dimension+1)*sizeof(vertex_t));
-    }
+    if (cpy._dimension >= 0)
+        memcpy(allocate(cpy._dimension), cpy.vertices(), (cpy._dimension+1)*sizeof(vertex_t));
+    memcpy(_mask, cpy._mask, sizeof(_mask));
+    _exactMask = cpy._exactMask;
+}
+
+Face::Face(Face && other) noexcept : _heapVertices(other._heapVertices), _dimension(other._dimension)
+{
+    if (_heapVertices == 0 && _dimension >= 0)
+        memcpy(_inlineVertices, other._inlineVertices, (_dimension+1)*sizeof(vertex_t));
+    memcpy(_mask, other._mask, sizeof(_mask));
+    _exactMask = other._exactMask;
+    
+    other._heapVertices = 0;
+    other._dimension = -1;
+    other.updateMask();
 }
 
 Face::~Face()
 {
-    if (_vertices != 0)
+    if (_heapVertices != 0)
     {
-        delete[] _vertices;
+        delete[] _heapVertices;
     }
 }
 
@@ -55,35 +66,119 @@ Face & Face::operator=(const Face & cpy)
     if (this == &cpy)
         return *this;
     
-    if (_vertices != 0)
+    if (cpy._dimension >= 0)
     {
-        delete[] _vertices;
-        _vertices = 0;
+        memcpy(allocate(cpy._dimension), cpy.vertices(), (cpy._dimension+1)*sizeof(vertex_t));
     }
-    if (cpy._vertices != 0)
+    else
     {
-        _vertices = new vertex_t[cpy._dimension+1];
-        memcpy(_vertices, cpy._vertices, (cpy._dimension+1)*sizeof(vertex_t));
+        allocate(-1);
     }
+    memcpy(_mask, cpy._mask, sizeof(_mask));
+    _exactMask = cpy._exactMask;
     
-    _dimension = cpy._dimension;
+    return *this;
+}
+
+Face & Face::operator=(Face && other) noexcept
+{
+    if (this == &other)
+        return *this;
+    
+    if (_heapVertices != 0)
+        delete[] _heapVertices;
+    
+    _heapVertices = other._heapVertices;
+    _dimension = other._dimension;
+    if (_heapVertices == 0 && _dimension >= 0)
+        memcpy(_inlineVertices, other._inlineVertices, (_dimension+1)*sizeof(vertex_t));
+    memcpy(_mask, other._mask, sizeof(_mask));
+    _exactMask = other._exactMask;
+    
+    other._heapVertices = 0;
+    other._dimension = -1;
+    other.updateMask();
     
     return *this;
 }
 
+vertex_t * Face::allocate(int dimension)
+{
+    // keep a heap buffer that is already large enough
+    if (_heapVertices != 0 && (dimension < Bistellar_inline_vertices || dimension > _dimension))
+    {
+        delete[] _heapVertices;
+        _heapVertices = 0;
+    }
+    if (_heapVertices == 0 && dimension >= Bistellar_inline_vertices)
+        _heapVertices = new vertex_t[dimension+1];
+    
+    _dimension = (dimension < 0 ? -1 : dimension);
+    
+    return vertices();
+}
+
+vertex_t * Face::vertices()
+{
+    return (_heapVertices != 0) ? _heapVertices : _inlineVertices;
+}
+
+const vertex_t * Face::vertices() const
+{
+    return (_heapVertices != 0) ? _heapVertices : _inlineVertices;
+}
+
+void Face::updateMask()
+{
+    memset(_mask, 0, sizeof(_mask));
+    _exactMask = true;
+    
+    const vertex_t * vertices = this->vertices();
+    for (int i = 0; i < _dimension+1; i++)
+    {
+        _mask[(vertices[i] % maskBits) / 64] |= 1ULL << (vertices[i] % 64);
+        if (vertices[i] >= maskBits)
+            _exactMask = false;
+    }
+}
+
+Face Face::fromMask(const unsigned long long * mask)
+{
+    int numberOfVertices = 0;
+    for (unsigned int w = 0; w < Bistellar_vertex_mask_words; w++)
+        numberOfVertices += __builtin_popcountll(mask[w]);
+    
+    Face face;
+    vertex_t * vertices = face.allocate(numberOfVertices-1);
+    for (unsigned int w = 0; w < Bistellar_vertex_mask_words; w++)
+    {
+        for (unsigned long long bits = mask[w]; bits != 0; bits &= bits - 1)
+            *(vertices++) = 64*w + __builtin_ctzll(bits);
+    }
+    memcpy(face._mask, mask, sizeof(face._mask));
+    face._exactMask = true;
+    
+    return face;
+}
+
 bool Face::operator==(const Face & cmp) const
 {
     if (cmp._dimension != _dimension)
         return false;
     
-    if (_vertices == 0 && cmp._vertices == 0)
+    for (unsigned int w = 0; w < Bistellar_vertex_mask_words; w++)
+    {
+        if (_mask[w] != cmp._mask[w])
+            return false;
+    }
+    if (_exactMask && cmp._exactMask)
         return true;
-    if (_vertices == 0 || cmp._vertices == 0)
-        return false;
-        
+    
+    const vertex_t * vertices = this->vertices();
+    const vertex_t * cmpVertices = cmp.vertices();
     for (int i = 0; i < _dimension+1; i++)
     {
-        if (vertex_t_compare(&cmp._vertices[i], &_vertices[i]) != 0)
+        if (vertex_t_compare(&cmpVertices[i], &vertices[i]) != 0)
             return false;
     }
     
@@ -100,26 +195,42 @@ int Face::dimension() const
     return _dimension;
 }
 
+size_t Face::hash() const
+{
+    const vertex_t * vertices = this->vertices();
+    size_t hash = static_cast< size_t >(_dimension + 1);
+    for (int i = 0; i < _dimension+1; i++)
+        hash ^= static_cast< size_t >(vertices[i]) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    
+    return hash;
+}
+
+size_t FaceHash::operator()(const Face & face) const
+{
+    return face.hash();
+}
+
 const vertex_t & Face::vertex(unsigned int i) const
 {
-    return _vertices[i];
+    return vertices()[i];
 }
 
-Face * Face::createBoundaryFace( unsigned int i ) const
+Face Face::boundaryFace( unsigned int i ) const
 {
-    if (i > _dimension || _vertices == 0)
-        return 0;
+    Face boundaryFace;
+    if (_dimension == -1 || i > _dimension)
+        return boundaryFace;
     
     if (_dimension == 0)
         std::cout << "ERROR: tried to create boundary of a vertex." << std::endl;
     
-    Face * boundaryFace = new Face;
-    boundaryFace->_dimension = _dimension-1;
-    boundaryFace->_vertices = new vertex_t[_dimension];
+    const vertex_t * vertices = this->vertices();
+    vertex_t * boundaryVertices = boundaryFace.allocate(_dimension-1);
     if (i != 0)
-        memcpy(&(boundaryFace->_vertices[0]), &(_vertices[0]), i*sizeof(vertex_t));
+        memcpy(&(boundaryVertices[0]), &(vertices[0]), i*sizeof(vertex_t));
     if (i != _dimension)
-        memcpy(&(boundaryFace->_vertices[i]), &(_vertices[i+1]), (_dimension-i)*sizeof(vertex_t));
+        memcpy(&(boundaryVertices[i]), &(vertices[i+1]), (_dimension-i)*sizeof(vertex_t));
+    boundaryFace.updateMask();
     
     return boundaryFace;
 }
@@ -139,16 +250,25 @@ bool Face::isSubfaceOf(const Face & face) const
     if (j > face._dimension)
         return false;*/
     
+    for (unsigned int w = 0; w < Bistellar_vertex_mask_words; w++)
+    {
+        if ((_mask[w] & ~face._mask[w]) != 0)
+            return false;
+    }
+    if (_exactMask && face._exactMask)
+        return true;
+    
+    const vertex_t * vertices = this->vertices();
+    const vertex_t * faceVertices = face.vertices();
     int i = 0;
     int j = 0;
     while (i < _dimension+1 && j < face._dimension+1)
     {
-        const int comparison = vertex_t_compare(&(_vertices[i]), &(face._vertices[j]));
-        if (comparison == 0)
+        if (vertices[i] == faceVertices[j])
         {
             i++;
         }
-        else if (comparison < 0)
+        else if (vertices[i] < faceVertices[j])
         {
             return false;
         }
@@ -161,17 +281,24 @@ bool Face::isSubfaceOf(const Face & face) const
     return true;
 }
 
-// serialization methods
-std::ostream & operator<< (std::ostream & os, const Face & face)
+void Face::write(std::string & buffer) const
 {
-    if (face._vertices == 0)
-    {
-        os<<"[]";
-    }
-    else
+    buffer += '[';
+    for (int i = 0; i < _dimension+1; i++)
     {
-        list_print(os, &(face._vertices[0]), &(face._vertices[face._dimension+1]));
+        if (i > 0)
+            buffer += ',';
+        write_decimal(buffer, vertices()[i]);
     }
+    buffer += ']';
+}
+
+// serialization methods
+std::ostream & operator<< (std::ostream & os, const Face & face)
+{
+    std::string & buffer = output_buffer();
+    face.write(buffer);
+    os.write(buffer.data(), buffer.size());
         
     return os;
 }
@@ -194,27 +321,48 @@ std::istream & operator>> (std::istream & is, Face & face)
 
 Face Face::linkFace(const Face & face, const face_list_t & linkFacets)
 {
+    bool exactMasks = face._exactMask;
+    for (face_list_t::const_iterator it = linkFacets.begin(); it != linkFacets.end() && exactMasks; it++)
+        exactMasks = it->_exactMask;
+    
+    if (exactMasks)
+    {
+        unsigned long long mask[Bistellar_vertex_mask_words] = {0};
+        for (face_list_t::const_iterator it = linkFacets.begin(); it != linkFacets.end(); it++)
+        {
+            for (unsigned int w = 0; w < Bistellar_vertex_mask_words; w++)
+                mask[w] |= it->_mask[w];
+        }
+        for (unsigned int w = 0; w < Bistellar_vertex_mask_words; w++)
+            mask[w] &= ~face._mask[w];
+        
+        return fromMask(mask);
+    }
+    
     size_t size = 0;
     for (face_list_t::const_iterator it = linkFacets.begin(); it != linkFacets.end(); it++)
     {
         size += it->_dimension+1;
     }
 
-    vertex_t * linkVertices = new vertex_t[size];
+    // links of moves are small, so the vertices usually fit into a buffer on the stack
+    vertex_t stackVertices[Bistellar_inline_vertices * Bistellar_inline_vertices];
+    vertex_t * linkVertices = (size <= Bistellar_inline_vertices * Bistellar_inline_vertices) ? stackVertices : new vertex_t[size];
     
     size_t pos = 0;
     for (face_list_t::const_iterator it = linkFacets.begin(); it != linkFacets.end(); it++)
     {
-        memcpy(&(linkVertices[pos]), it->_vertices, (it->_dimension+1)*sizeof(vertex_t));
+        memcpy(&(linkVertices[pos]), it->vertices(), (it->_dimension+1)*sizeof(vertex_t));
         pos += (it->_dimension+1);
     }
     
     qsort(linkVertices, size, sizeof(vertex_t), &vertex_t_compare);
     size = remove_duplicates(linkVertices, size, sizeof(vertex_t), &vertex_t_compare);
-    size = remove_from_set(linkVertices, size, face._vertices, face._dimension+1, sizeof(vertex_t), &vertex_t_compare);
+    size = remove_from_set(linkVertices, size, face.vertices(), face._dimension+1, sizeof(vertex_t), &vertex_t_compare);
     
     Face linkFace(linkVertices, static_cast< int >(size)-1);
-    delete[] linkVertices;
+    if (linkVertices != stackVertices)
+        delete[] linkVertices;
     
     return linkFace;
 }
@@ -226,15 +374,26 @@ Face Face::unite(const Face & face1, const Face & face2)
     if (face2.dimension() == -1)
         return face1;
     
-    vertex_t * vertices = new vertex_t[face1._dimension + face2._dimension + 2];
-    memcpy(vertices, face1._vertices, (face1._dimension+1)*sizeof(vertex_t));
-    memcpy(&(vertices[face1._dimension+1]), face2._vertices, (face2._dimension+1)*sizeof(vertex_t));
+    if (face1._exactMask && face2._exactMask)
+    {
+        unsigned long long mask[Bistellar_vertex_mask_words];
+        for (unsigned int w = 0; w < Bistellar_vertex_mask_words; w++)
+            mask[w] = face1._mask[w] | face2._mask[w];
+        
+        return fromMask(mask);
+    }
+    
+    vertex_t stackVertices[2 * Bistellar_inline_vertices];
+    vertex_t * vertices = (face1._dimension + face2._dimension + 2 <= 2 * Bistellar_inline_vertices) ? stackVertices : new vertex_t[face1._dimension + face2._dimension + 2];
+    memcpy(vertices, face1.vertices(), (face1._dimension+1)*sizeof(vertex_t));
+    memcpy(&(vertices[face1._dimension+1]), face2.vertices(), (face2._dimension+1)*sizeof(vertex_t));
     
     qsort(vertices, face1._dimension + face2._dimension + 2, sizeof(vertex_t), &vertex_t_compare);
     size_t size = remove_duplicates(vertices, face1._dimension + face2._dimension + 2, sizeof(vertex_t), &vertex_t_compare);
     
     Face unionFace(vertices, static_cast< int >(size)-1);
-    delete[] vertices;
+    if (vertices != stackVertices)
+        delete[] vertices;
     
     return unionFace;
 }
@@ -242,7 +401,8 @@ Face Face::unite(const Face & face1, const Face & face2)
 
 void addBoundaryfacesOfFace(const Face & face, face_list_t & listOfBoundaryfaces)
 {
-    vertex_t * boundaryfaceVertices = (face.dimension() < 1 ? 0 : new vertex_t[face.dimension()]);
+    vertex_t stackVertices[Bistellar_inline_vertices];
+    vertex_t * boundaryfaceVertices = (face.dimension() <= Bistellar_inline_vertices ? stackVertices : new vertex_t[face.dimension()]);
     
     for (unsigned int i = 0; i < face.dimension(); i++)
         boundaryfaceVertices[i] = face.vertex(i+1);
@@ -255,28 +415,23 @@ void addBoundaryfacesOfFace(const Face & face, face_list_t & listOfBoundaryfaces
         listOfBoundaryfaces.push_back(Face(boundaryfaceVertices, face.dimension()-1));
     }
     
-    if (boundaryfaceVertices != 0)
+    if (boundaryfaceVertices != stackVertices)
         delete[] boundaryfaceVertices;
 }
 
-void incrementBitmask(std::vector< bool > & bitmask);
-
 void addSubfacesOfFace(const Face & face, face_list_t & listOfSubfaces)
 {
-    vertex_t * subfaceVertices = (face.dimension() < 1 ? 0 : new vertex_t[face.dimension()]);
+    vertex_t stackVertices[Bistellar_inline_vertices];
+    vertex_t * subfaceVertices = (face.dimension() <= Bistellar_inline_vertices ? stackVertices : new vertex_t[face.dimension()]);
     
-    std::vector< bool > bitmask(face.dimension()+1, false);
-    for (unsigned long long int i = 0; i < (face.dimension() < 0 ? 0 : (1<<(face.dimension()+1))-2); i++)
+    // the bits of mask select the vertices of the subface, the empty face and face itself are omitted
+    const unsigned long long int numberOfMasks = (face.dimension() < 0 ? 0 : (1ULL<<(face.dimension()+1))-1);
+    for (unsigned long long int mask = 1; mask < numberOfMasks; mask++)
     {
-        incrementBitmask(bitmask);
-        
         unsigned int subfaceSize = 0;
-        std::vector< bool >::const_iterator it;
-        unsigned int index;
-        
-        for (it = bitmask.begin(), index = 0; it != bitmask.end(); it++, index++)
+        for (unsigned int index = 0; index < face.dimension()+1; index++)
         {
-            if (*it)
+            if (mask & (1ULL<<index))
             {
                 subfaceVertices[subfaceSize] = face.vertex(index);
                 subfaceSize++;
@@ -286,17 +441,6 @@ void addSubfacesOfFace(const Face & face, face_list_t & listOfSubfaces)
         listOfSubfaces.push_back(Face(subfaceVertices, subfaceSize-1));
     }
     
-    if (subfaceVertices != 0)
+    if (subfaceVertices != stackVertices)
         delete[] subfaceVertices;
 }
-
-void incrementBitmask(std::vector< bool > & bitmask)
-{
-    std::vector< bool >::iterator it = bitmask.begin();
-    while (it != bitmask.end())
-    {
-        if ((*it = !*it))
-            break;
-        it++;
-    }
-}
\ No newline at end of file
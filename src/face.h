@@ -11,19 +11,37 @@
 
 #include <iostream>
 #include <deque>
+#include <string>
 #include "types.h"
 
 class Face
 {
-    vertex_t * _vertices;
+    // vertices of faces with up to Bistellar_inline_vertices vertices are stored inline, larger faces use _heapVertices.
+    vertex_t _inlineVertices[Bistellar_inline_vertices];
+    vertex_t * _heapVertices;
     int _dimension;
     
+    // bitset of the vertices modulo 64*Bistellar_vertex_mask_words, exact if all vertices are below this bound.
+    unsigned long long _mask[Bistellar_vertex_mask_words];
+    bool _exactMask;
+    
+    // sets the dimension and provides (uninitialized) storage for the vertices.
+    vertex_t * allocate(int dimension);
+    vertex_t * vertices();
+    const vertex_t * vertices() const;
+    // recomputes the bitset from the vertices.
+    void updateMask();
+    // creates the face given by an exact bitset.
+    static Face fromMask(const unsigned long long * mask);
+    
 public:
     Face();
     Face(const vertex_t * vertices, int dimension);
     
     Face(const Face & cpy);
+    Face(Face && other) noexcept;
     Face & operator=(const Face & cpy);
+    Face & operator=(Face && other) noexcept;
     
     ~Face();
     
@@ -32,11 +50,14 @@ public:
     
     int dimension() const;
     
+    // returns a hash value of the vertex tuple. Equal faces have equal hashes.
+    size_t hash() const;
+    
     // returns a reference to the i-th vertex.
     const vertex_t & vertex(unsigned int i) const;
     
     // returns the boundary face obtained by omitting the i-th vertex.
-    Face * createBoundaryFace(unsigned int i) const;
+    Face boundaryFace(unsigned int i) const;
     
     // tests if the face is a subface of face
     bool isSubfaceOf(const Face & face) const;
@@ -48,6 +69,9 @@ public:
     static Face unite(const Face & face1, const Face & face2);
     
     
+    // appends the face in the format [v_1,...,v_n] to buffer
+    void write(std::string & buffer) const;
+    
     // serialization methods
     friend std::ostream & operator<< (std::ostream & os, const Face & face);
     friend std::istream & operator>> (std::istream & is, Face & face);
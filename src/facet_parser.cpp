@@ -0,0 +1,252 @@
+//
+//  facet_parser.cpp
+//  Bistellar
+//
+
+#include "facet_parser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
+#include "binary_complex.h"
+#include "util.h"
+
+static const char * skipWhitespace(const char * first, const char * last)
+{
+    while (first != last && (*first == ' ' || *first == '\t' || *first == '\n' || *first == '\r'))
+        first++;
+
+    return first;
+}
+
+// sets error to message at the offset of position and returns 0
+static const char * parseError(const char * begin, const char * position, const char * message, std::string & error)
+{
+    std::ostringstream os;
+    os << message << " at offset " << (position - begin);
+    error = os.str();
+
+    return 0;
+}
+
+const char * parse_facets(const char * first, const char * last, face_list_t & facets, std::string & error)
+{
+    const char * begin = first;
+    const char * it = skipWhitespace(first, last);
+    if (it == last || *it != '[')
+        return parseError(begin, it, "expected '[' opening the facet list", error);
+    it = skipWhitespace(it+1, last);
+
+    std::vector< vertex_t > vertices;
+    int dimension = -1;
+    if (it != last && *it == ']')
+        return it+1;
+
+    while (true)
+    {
+        if (it == last || *it != '[')
+            return parseError(begin, it, "expected '[' opening a facet", error);
+        const char * facetStart = it;
+        it = skipWhitespace(it+1, last);
+
+        vertices.clear();
+        while (true)
+        {
+            if (it == last || *it < '0' || *it > '9')
+                return parseError(begin, it, "expected a vertex", error);
+
+            unsigned long long vertex = 0;
+            for (; it != last && *it >= '0' && *it <= '9'; it++)
+            {
+                vertex = 10*vertex + (*it - '0');
+                if (vertex > std::numeric_limits< vertex_t >::max())
+                    return parseError(begin, it, "vertex out of range", error);
+            }
+            vertices.push_back(static_cast< vertex_t >(vertex));
+
+            it = skipWhitespace(it, last);
+            if (it != last && *it == ',')
+            {
+                it = skipWhitespace(it+1, last);
+            }
+            else if (it != last && *it == ']')
+            {
+                it++;
+                break;
+            }
+            else
+            {
+                return parseError(begin, it, "expected ',' or ']' in a facet", error);
+            }
+        }
+
+        if (dimension == -1)
+            dimension = static_cast< int >(vertices.size()) - 1;
+        else if (static_cast< int >(vertices.size()) - 1 != dimension)
+            return parseError(begin, facetStart, "facet of different dimension", error);
+        facets.emplace_back(vertices.data(), dimension);
+        // Face sorts its vertices, so repeated ones end up next to each other
+        const vertex_t * sorted = &facets.back().vertex(0);
+        if (std::adjacent_find(sorted, sorted + dimension+1) != sorted + dimension+1)
+            return parseError(begin, facetStart, "repeated vertex in a facet", error);
+
+        it = skipWhitespace(it, last);
+        if (it != last && *it == ',')
+            it = skipWhitespace(it+1, last);
+        else if (it != last && *it == ']')
+            return it+1;
+        else
+            return parseError(begin, it, "expected ',' or ']' in the facet list", error);
+    }
+}
+
+// returns the argument of option name=... at first, which is empty if first does not start with the option
+static std::string optionArgument(const char * first, const char * last, const char * name, const char *& end)
+{
+    size_t length = std::char_traits< char >::length(name);
+    end = first;
+    if (static_cast< size_t >(last - first) <= length || !std::equal(name, name + length, first))
+        return std::string();
+
+    end = first + length;
+    while (end != last && *end != ' ' && *end != '\t' && *end != '\r')
+        end++;
+
+    return std::string(first + length, end);
+}
+
+bool read_complex(const std::string & line, std::istream & is, std::istream & input, MovableComplex & complex, std::string & error)
+{
+    std::streamoff position = is.tellg();
+    if (position < 0 || static_cast< size_t >(position) > line.size())
+    {
+        error = "no facet list given";
+        return false;
+    }
+
+    face_list_t facets;
+    const char * last = line.data() + line.size();
+    const char * first = skipWhitespace(line.data() + position, last);
+    const char * end;
+    const char * pathEnd;
+    const char * bytesEnd;
+    std::string path = optionArgument(first, last, "file=", pathEnd);
+    std::string bytes = optionArgument(first, last, "binary=", bytesEnd);
+    if (!path.empty())
+    {
+        if (!read_complex_file(path, facets, error))
+            return false;
+        end = pathEnd;
+    }
+    else if (!bytes.empty())
+    {
+        // the complex in the binary format follows the line on input, with exactly the given number of bytes
+        std::string payload(std::strtoul(bytes.c_str(), 0, 10), '\0');
+        if (payload.empty() || !input.read(&payload[0], payload.size()))
+        {
+            error = "expected " + bytes + " bytes of binary input";
+            return false;
+        }
+        if (decode_facets(payload.data(), payload.data() + payload.size(), facets, error) != payload.data() + payload.size())
+        {
+            if (error.empty())
+                error = "binary input longer than the complex";
+            return false;
+        }
+        end = bytesEnd;
+    }
+    else
+    {
+        end = parse_facets(first, last, facets, error);
+        if (end == 0)
+            return false;
+    }
+    if (facets.empty())
+    {
+        error = "complex has no facets";
+        return false;
+    }
+
+    is.seekg(end - line.data());
+    complex = MovableComplex(facets, facets.front().dimension());
+
+    return true;
+}
+
+void benchmark_io(std::ostream & os, unsigned int numberOfFacets, unsigned int dimension, unsigned int seed, const std::string & output)
+{
+    std::seed_seq seeds = {seed, 0u};
+    random_engine_t rng(seeds);
+
+    // facets of distinct random vertices, with about as many vertices as facets as in large triangulations
+    unsigned int numberOfVertices = std::max(numberOfFacets, dimension+1);
+    std::ostringstream text;
+    std::vector< vertex_t > vertices(dimension+1);
+    text << "[";
+    for (unsigned int i = 0; i < numberOfFacets; i++)
+    {
+        for (unsigned int j = 0; j < dimension+1; j++)
+        {
+            do
+                vertices[j] = 1 + rng() % numberOfVertices;
+            while (std::find(vertices.begin(), vertices.begin() + j, vertices[j]) != vertices.begin() + j);
+        }
+        text << (i > 0 ? ",[" : "[") << vertices[0];
+        for (unsigned int j = 1; j < dimension+1; j++)
+            text << "," << vertices[j];
+        text << "]";
+    }
+    text << "]";
+    std::string input = text.str();
+    double megabytes = input.size() / 1e6;
+    os << "generated " << numberOfFacets << " facets of dimension " << dimension << ", " << megabytes << " MB" << std::endl;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::stringstream stream(input);
+    face_list_t streamFacets;
+    list_read(stream, streamFacets);
+    double milliseconds = std::chrono::duration< double, std::milli >(std::chrono::steady_clock::now() - start).count();
+    os << "list_read parsed " << streamFacets.size() << " facets in " << milliseconds << " ms, " << megabytes / (milliseconds / 1000) << " MB/s" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    face_list_t facets;
+    std::string error;
+    bool parsed = parse_facets(input.data(), input.data() + input.size(), facets, error) != 0;
+    milliseconds = std::chrono::duration< double, std::milli >(std::chrono::steady_clock::now() - start).count();
+    if (parsed)
+        os << "parse_facets parsed " << facets.size() << " facets in " << milliseconds << " ms, " << megabytes / (milliseconds / 1000) << " MB/s" << std::endl;
+    else
+        os << "parse_facets failed: " << error << std::endl;
+
+    std::ofstream file(output.c_str());
+    if (!file)
+    {
+        os << "could not open " << output << std::endl;
+        return;
+    }
+
+    start = std::chrono::steady_clock::now();
+    file << "[";
+    for (face_list_t::const_iterator it = facets.begin(); it != facets.end(); it++)
+    {
+        file << (it != facets.begin() ? ",[" : "[") << it->vertex(0) << std::flush;
+        for (int i = 1; i < it->dimension()+1; i++)
+            file << "," << it->vertex(i) << std::flush;
+        file << "]";
+    }
+    file << "]" << std::endl;
+    milliseconds = std::chrono::duration< double, std::milli >(std::chrono::steady_clock::now() - start).count();
+    os << "flushing per element wrote " << facets.size() << " facets in " << milliseconds << " ms, " << megabytes / (milliseconds / 1000) << " MB/s" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    std::string & buffer = output_buffer();
+    write_list(buffer, facets.begin(), facets.end());
+    file.write(buffer.data(), buffer.size());
+    file << std::endl;
+    milliseconds = std::chrono::duration< double, std::milli >(std::chrono::steady_clock::now() - start).count();
+    os << "buffered output wrote " << facets.size() << " facets in " << milliseconds << " ms, " << megabytes / (milliseconds / 1000) << " MB/s" << std::endl;
+}
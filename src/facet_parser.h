@@ -0,0 +1,31 @@
+//
+//  facet_parser.h
+//  Bistellar
+//
+
+#ifndef Bistellar_facet_parser_h
+#define Bistellar_facet_parser_h
+
+#include <iostream>
+#include <string>
+#include "types.h"
+#include "face.h"
+#include "movable_complex.h"
+
+// parses a facet list [[v,...],...] from the characters [first, last), skipping whitespace. The vertices of each facet
+// are collected in a reused buffer and the facet is constructed in place in facets. Returns a pointer past the list,
+// or 0 if the input is malformed or the facets are not all of the same dimension, in which case error describes the
+// problem and its offset from first.
+const char * parse_facets(const char * first, const char * last, face_list_t & facets, std::string & error);
+
+// reads a complex from line, starting at the position of is, which must be a stream over line, and moves is past it.
+// The complex is given as facet list, as file=%f naming a file read by read_complex_file, or as binary=N when N bytes
+// of it in the binary format follow the line on input. Returns false and sets error if it is malformed or empty.
+bool read_complex(const std::string & line, std::istream & is, std::istream & input, MovableComplex & complex, std::string & error);
+
+// generates a facet list of the given number of random facets of the given dimension and measures how fast it is
+// parsed by list_read and by parse_facets, and how fast it is written to the file output, element by element with a
+// flush after each as formerly and formatted into one buffer. The results are written to os.
+void benchmark_io(std::ostream & os, unsigned int numberOfFacets, unsigned int dimension, unsigned int seed, const std::string & output);
+
+#endif
@@ -0,0 +1,93 @@
+//
+//  hasse_diagram.cpp
+//  Bistellar
+//
+
+#include "hasse_diagram.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+static bool lexicographicLess(const Face & face1, const Face & face2)
+{
+    for (int i = 0; i < face1.dimension()+1; i++)
+    {
+        if (face1.vertex(i) != face2.vertex(i))
+            return face1.vertex(i) < face2.vertex(i);
+    }
+
+    return false;
+}
+
+HasseDiagram::HasseDiagram(const MovableComplex & complex) : _dimension(complex.dimension()), _faces(_dimension+1), _boundaries(_dimension+1), _cofaceOffsets(_dimension+1), _cofaces(_dimension+1)
+{
+    for (unsigned int d = 0; d < _dimension+1; d++)
+    {
+        _faces[d].assign(complex.faces(d).begin(), complex.faces(d).end());
+        std::sort(_faces[d].begin(), _faces[d].end(), lexicographicLess);
+    }
+
+    std::unordered_map< Face, unsigned int, FaceHash > ids;
+    for (unsigned int d = 1; d < _dimension+1; d++)
+    {
+        ids.clear();
+        for (unsigned int i = 0; i < _faces[d-1].size(); i++)
+            ids.emplace(_faces[d-1][i], i);
+
+        _boundaries[d].resize((d+1) * _faces[d].size());
+        for (unsigned int i = 0; i < _faces[d].size(); i++)
+        {
+            for (unsigned int j = 0; j < d+1; j++)
+                _boundaries[d][(d+1)*i + j] = ids[_faces[d][i].boundaryFace(j)];
+        }
+
+        // the cofaces are the transposed boundaries, counted first and then filled in
+        std::vector< unsigned int > & offsets = _cofaceOffsets[d-1];
+        offsets.assign(_faces[d-1].size() + 1, 0);
+        for (std::vector< unsigned int >::const_iterator it = _boundaries[d].begin(); it != _boundaries[d].end(); it++)
+            offsets[*it + 1]++;
+        for (unsigned int i = 0; i < _faces[d-1].size(); i++)
+            offsets[i+1] += offsets[i];
+
+        std::vector< unsigned int > positions(offsets.begin(), offsets.end() - 1);
+        _cofaces[d-1].resize(_boundaries[d].size());
+        for (unsigned int i = 0; i < _faces[d].size(); i++)
+        {
+            for (unsigned int j = 0; j < d+1; j++)
+                _cofaces[d-1][positions[_boundaries[d][(d+1)*i + j]]++] = i;
+        }
+    }
+
+    // the facets have no cofaces
+    _cofaceOffsets[_dimension].assign(_faces[_dimension].size() + 1, 0);
+}
+
+unsigned int HasseDiagram::dimension() const
+{
+    return _dimension;
+}
+
+unsigned int HasseDiagram::f(unsigned int d) const
+{
+    return static_cast< unsigned int >(_faces[d].size());
+}
+
+const Face & HasseDiagram::face(unsigned int d, unsigned int i) const
+{
+    return _faces[d][i];
+}
+
+const unsigned int * HasseDiagram::boundary(unsigned int d, unsigned int i) const
+{
+    return &_boundaries[d][(d+1)*i];
+}
+
+unsigned int HasseDiagram::numberOfCofaces(unsigned int d, unsigned int i) const
+{
+    return _cofaceOffsets[d][i+1] - _cofaceOffsets[d][i];
+}
+
+const unsigned int * HasseDiagram::cofaces(unsigned int d, unsigned int i) const
+{
+    return _cofaces[d].data() + _cofaceOffsets[d][i];
+}
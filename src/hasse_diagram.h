@@ -0,0 +1,41 @@
+//
+//  hasse_diagram.h
+//  Bistellar
+//
+
+#ifndef Bistellar_hasse_diagram_h
+#define Bistellar_hasse_diagram_h
+
+#include <vector>
+#include "types.h"
+#include "face.h"
+#include "movable_complex.h"
+
+// The face lattice of a complex in compact form. The faces of every dimension are numbered lexicographically,
+// and the incidences between neighboring dimensions are stored as arrays of these ids.
+class HasseDiagram
+{
+    unsigned int _dimension;
+    // _faces[d][i] is the face of dimension d with id i
+    std::vector< std::vector< Face > > _faces;
+    // the ids of the d+1 boundary faces of the face i of dimension d > 0 are _boundaries[d][(d+1)*i], ..., _boundaries[d][(d+1)*i+d]
+    std::vector< std::vector< unsigned int > > _boundaries;
+    // the ids of the cofaces of the face i of dimension d < dimension are _cofaces[d][_cofaceOffsets[d][i]], ..., _cofaces[d][_cofaceOffsets[d][i+1]-1]
+    std::vector< std::vector< unsigned int > > _cofaceOffsets;
+    std::vector< std::vector< unsigned int > > _cofaces;
+
+public:
+    explicit HasseDiagram(const MovableComplex & complex);
+
+    unsigned int dimension() const;
+    unsigned int f(unsigned int d) const;
+    const Face & face(unsigned int d, unsigned int i) const;
+
+    // returns the ids of the boundary faces of the face i of dimension d > 0, an array of d+1 ids
+    const unsigned int * boundary(unsigned int d, unsigned int i) const;
+    // returns the number of cofaces of the face i of dimension d and the array of their ids
+    unsigned int numberOfCofaces(unsigned int d, unsigned int i) const;
+    const unsigned int * cofaces(unsigned int d, unsigned int i) const;
+};
+
+#endif
@@ -6,19 +6,39 @@
 //  Copyright 2011 -. All rights reserved.
 //
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include "types.h"
 #include "movable_complex.h"
 #include "face.h"
 #include "util.h"
 #include "randomize_complex.h"
 #include "reduce_complex.h"
+#include "temper_complex.h"
+#include "equivalent_complex.h"
+#include "collapse_complex.h"
+#include "complex_homology.h"
+#include "complex_isomorphism.h"
+#include "complex_sessions.h"
+#include "facet_parser.h"
+#include "recognize_manifold.h"
+#include "move_trace.h"
+#include "binary_complex.h"
+#include "complex_library.h"
+#include "batch_complexes.h"
 
 int main (int argc, const char * argv[])
 {
+    // input lines of large complexes are read in bulk, not synchronized character by character with stdio
+    std::ios::sync_with_stdio(false);
     std::istream & in = std::cin;
+    ComplexSessions sessions;
     
     while (true)
     {
@@ -31,14 +51,26 @@ int main (int argc, const char * argv[])
         
         if (command.compare("randomize") == 0)
         {
-            MovableComplex complex;
-            sstream >> complex;
+            MovableComplex parsed;
+            unsigned int handle;
+            std::string error;
+            MovableComplex * loaded = sessions.read(line, sstream, in, parsed, handle, error);
+            if (loaded == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            MovableComplex & complex = *loaded;
             
             std::vector< unsigned int > allowedMoves;
             for (unsigned int i = 0; i < complex.dimension()+1; i++)
                 allowedMoves.push_back(i);
             
             unsigned int rounds = 50;
+            unsigned int seed = random_seed();
+            std::string tracePath;
+            std::string outPath;
+            bool relabel = false;
             
             std::string nextToken;
             while (sstream >> nextToken)
@@ -57,20 +89,70 @@ int main (int argc, const char * argv[])
                     token.ignore(token.str().length(),'=');
                     token >> rounds;
                 }
+                else if (token.str().compare(0,4,"seed") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> seed;
+                }
+                else if (token.str().compare(0,5,"trace") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> tracePath;
+                }
+                else if (token.str().compare(0,7,"relabel") == 0)
+                {
+                    relabel = read_flag(token);
+                }
+                else if (token.str().compare(0,3,"out") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> outPath;
+                }
             }
             
-            randomize_complex(complex, allowedMoves, rounds);
+            MoveTrace trace;
+            randomize_complex(complex, allowedMoves, rounds, seed, tracePath.empty() ? 0 : &trace);
+            if (!tracePath.empty() && !trace.write(tracePath))
+                std::cerr << "could not write trace file " << tracePath << std::endl;
+            if (relabel)
+                complex.relabel();
             
-            std::cout << "resulting complex is " << complex << std::endl;
+            if (!outPath.empty())
+            {
+                if (write_complex_file(outPath, complex, error))
+                    std::cout << "resulting file is " << outPath << " with " << complex.f(0) << " vertices" << std::endl;
+                else
+                    std::cout << error << std::endl;
+            }
+            else if (handle != 0)
+                std::cout << "resulting handle is " << handle << " with " << complex.f(0) << " vertices" << std::endl;
+            else
+                std::cout << "resulting complex is " << complex << std::endl;
         }
         else if (command.compare("reduce") == 0)
         {
-            MovableComplex complex;
-            sstream >> complex;
+            MovableComplex parsed;
+            unsigned int handle;
+            std::string error;
+            MovableComplex * loaded = sessions.read(line, sstream, in, parsed, handle, error);
+            if (loaded == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            MovableComplex & complex = *loaded;
             
             unsigned int rounds = 10000;
+            const ReductionSchedule * schedule = reduction_schedule("default");
             int heating = 0;
             int relaxation = 4;
+            unsigned int threads = 1;
+            unsigned int abandon = 0;
+            unsigned int tabu = 0;
+            unsigned int seed = random_seed();
+            std::string tracePath;
+            std::string outPath;
+            bool relabel = false;
             
             std::string nextToken;
             while (sstream >> nextToken)
@@ -87,16 +169,709 @@ int main (int argc, const char * argv[])
                     token.ignore(token.str().length(),'=');
                     token >> heating;
                 }
-                else if (token.str().compare(0,9,"relaxation") == 0)
+                else if (token.str().compare(0,10,"relaxation") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> relaxation;
+                }
+                else if (token.str().compare(0,8,"schedule") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    std::string name;
+                    token >> name;
+                    if (reduction_schedule(name) != 0)
+                        schedule = reduction_schedule(name);
+                    else
+                        std::cerr << "unknown schedule " << name << ", using the default schedule" << std::endl;
+                }
+                else if (token.str().compare(0,7,"threads") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> threads;
+                }
+                else if (token.str().compare(0,7,"abandon") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> abandon;
+                }
+                else if (token.str().compare(0,4,"tabu") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> tabu;
+                }
+                else if (token.str().compare(0,4,"seed") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> seed;
+                }
+                else if (token.str().compare(0,5,"trace") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> tracePath;
+                }
+                else if (token.str().compare(0,7,"relabel") == 0)
+                {
+                    relabel = read_flag(token);
+                }
+                else if (token.str().compare(0,3,"out") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> outPath;
+                }
+            }
+            
+            MoveTrace trace;
+            reduce_complex(complex, rounds, *schedule, heating, relaxation, threads, abandon, tabu, seed, tracePath.empty() ? 0 : &trace);
+            if (!tracePath.empty() && !trace.write(tracePath))
+                std::cerr << "could not write trace file " << tracePath << std::endl;
+            if (relabel)
+                complex.relabel();
+            
+            if (!outPath.empty())
+            {
+                if (write_complex_file(outPath, complex, error))
+                    std::cout << "resulting file is " << outPath << " with " << complex.f(0) << " vertices" << std::endl;
+                else
+                    std::cout << error << std::endl;
+            }
+            else if (handle != 0)
+                std::cout << "resulting handle is " << handle << " with " << complex.f(0) << " vertices" << std::endl;
+            else
+                std::cout << "resulting complex is " << complex << " with " << complex.f(0) << " vertices" << std::endl;
+        }
+        else if (command.compare("temper") == 0)
+        {
+            MovableComplex parsed;
+            unsigned int handle;
+            std::string error;
+            MovableComplex * loaded = sessions.read(line, sstream, in, parsed, handle, error);
+            if (loaded == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            MovableComplex & complex = *loaded;
+            
+            TemperingOptions options;
+            options.seed = random_seed();
+            bool relabel = false;
+            
+            std::string nextToken;
+            while (sstream >> nextToken)
+            {
+                std::stringstream token(nextToken);
+                
+                if (token.str().compare(0,6,"rounds") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> options.rounds;
+                }
+                else if (token.str().compare(0,8,"replicas") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> options.replicas;
+                }
+                else if (token.str().compare(0,4,"tmin") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> options.minTemperature;
+                }
+                else if (token.str().compare(0,4,"tmax") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> options.maxTemperature;
+                }
+                else if (token.str().compare(0,8,"exchange") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> options.exchangeInterval;
+                }
+                else if (token.str().compare(0,7,"threads") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> options.threads;
+                }
+                else if (token.str().compare(0,4,"seed") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> options.seed;
+                }
+                else if (token.str().compare(0,6,"target") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> options.target;
+                }
+                else if (token.str().compare(0,7,"relabel") == 0)
+                {
+                    relabel = read_flag(token);
+                }
+            }
+            
+            temper_complex(complex, options);
+            if (relabel)
+                complex.relabel();
+            
+            if (handle != 0)
+                std::cout << "resulting handle is " << handle << " with " << complex.f(0) << " vertices" << std::endl;
+            else
+                std::cout << "resulting complex is " << complex << " with " << complex.f(0) << " vertices" << std::endl;
+        }
+        else if (command.compare("equivalent") == 0)
+        {
+            MovableComplex complex;
+            unsigned int handle;
+            std::string error;
+            MovableComplex * loaded = sessions.read(line, sstream, in, complex, handle, error);
+            if (loaded == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            // the search moves the complex, so a loaded one is searched on a copy
+            if (handle != 0)
+                complex = *loaded;
+            
+            // the complexes may be separated by "and"
+            sstream >> std::ws;
+            if (std::isalpha(sstream.peek()))
+            {
+                std::string separator;
+                sstream >> separator;
+            }
+            MovableComplex parsedReference;
+            unsigned int referenceHandle;
+            MovableComplex * reference = sessions.read(line, sstream, in, parsedReference, referenceHandle, error);
+            if (reference == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            
+            unsigned int rounds = 100000;
+            const ReductionSchedule * schedule = reduction_schedule("default");
+            int heating = 0;
+            int relaxation = 4;
+            unsigned int seed = random_seed();
+            std::string tracePath;
+            
+            std::string nextToken;
+            while (sstream >> nextToken)
+            {
+                std::stringstream token(nextToken);
+                
+                if (token.str().compare(0,6,"rounds") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> rounds;
+                }
+                else if (token.str().compare(0,8,"schedule") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    std::string name;
+                    token >> name;
+                    if (reduction_schedule(name) != 0)
+                        schedule = reduction_schedule(name);
+                    else
+                        std::cerr << "unknown schedule " << name << ", using the default schedule" << std::endl;
+                }
+                else if (token.str().compare(0,7,"heating") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> heating;
+                }
+                else if (token.str().compare(0,10,"relaxation") == 0)
                 {
                     token.ignore(token.str().length(),'=');
                     token >> relaxation;
                 }
+                else if (token.str().compare(0,4,"seed") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> seed;
+                }
+                else if (token.str().compare(0,5,"trace") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> tracePath;
+                }
+            }
+            
+            MoveTrace trace;
+            equivalence_t equivalence = equivalent_complex(complex, *reference, rounds, *schedule, heating, relaxation, seed, tracePath.empty() ? 0 : &trace);
+            // the trace is only of interest if it leads to the reference
+            if (equivalence == equivalence_true && !tracePath.empty() && !trace.write(tracePath))
+                std::cerr << "could not write trace file " << tracePath << std::endl;
+            
+            if (equivalence == equivalence_true)
+                std::cout << "resulting equivalence is true" << std::endl;
+            else if (equivalence == equivalence_false)
+                std::cout << "resulting equivalence is false" << std::endl;
+            else
+                std::cout << "resulting equivalence is unknown" << std::endl;
+        }
+        else if (command.compare("isosig") == 0)
+        {
+            MovableComplex parsed;
+            unsigned int handle;
+            std::string error;
+            MovableComplex * loaded = sessions.read(line, sstream, in, parsed, handle, error);
+            if (loaded == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            MovableComplex & complex = *loaded;
+            
+            // the facets are read in place, a snapshot would start journaling the complex of a handle
+            std::string signature;
+            if (isomorphism_signature(complex.faces(complex.dimension()), signature))
+                std::cout << "resulting isosig is " << signature << std::endl;
+            else
+                std::cout << "resulting isosig is fail" << std::endl;
+        }
+        else if (command.compare("collapse") == 0)
+        {
+            MovableComplex parsed;
+            unsigned int handle;
+            std::string error;
+            MovableComplex * loaded = sessions.read(line, sstream, in, parsed, handle, error);
+            if (loaded == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            MovableComplex & complex = *loaded;
+            
+            morse_order_t order = morse_random;
+            unsigned int seed = random_seed();
+            
+            std::string nextToken;
+            while (sstream >> nextToken)
+            {
+                std::stringstream token(nextToken);
+                
+                if (token.str().compare(0,5,"order") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    std::string name;
+                    token >> name;
+                    if (!morse_order(name, order))
+                        std::cerr << "unknown order " << name << ", using random order" << std::endl;
+                }
+                else if (token.str().compare(0,4,"seed") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> seed;
+                }
+            }
+            
+            face_list_t remainder;
+            collapse_complex(complex, order, seed, remainder);
+            
+            std::set< vertex_t > vertices;
+            for (face_list_t::const_iterator it = remainder.begin(); it != remainder.end(); it++)
+            {
+                for (int i = 0; i < it->dimension()+1; i++)
+                    vertices.insert(it->vertex(i));
+            }
+            std::cout << "resulting complex is ";
+            list_print(std::cout, remainder.begin(), remainder.end());
+            std::cout << " with " << vertices.size() << " vertices" << std::endl;
+        }
+        else if (command.compare("morsespec") == 0)
+        {
+            MovableComplex parsed;
+            unsigned int handle;
+            std::string error;
+            MovableComplex * loaded = sessions.read(line, sstream, in, parsed, handle, error);
+            if (loaded == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            MovableComplex & complex = *loaded;
+            
+            unsigned int samples = 100;
+            morse_order_t order = morse_random;
+            unsigned int threads = std::thread::hardware_concurrency();
+            unsigned int seed = random_seed();
+            
+            std::string nextToken;
+            while (sstream >> nextToken)
+            {
+                std::stringstream token(nextToken);
+                
+                if (token.str().compare(0,7,"samples") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> samples;
+                }
+                else if (token.str().compare(0,5,"order") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    std::string name;
+                    token >> name;
+                    if (!morse_order(name, order))
+                        std::cerr << "unknown order " << name << ", using random order" << std::endl;
+                }
+                else if (token.str().compare(0,7,"threads") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> threads;
+                }
+                else if (token.str().compare(0,4,"seed") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> seed;
+                }
+            }
+            
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            morse_spectrum_t spectrum;
+            morse_spectrum(complex, std::max(samples, 1u), order, threads, seed, spectrum);
+            double milliseconds = std::chrono::duration< double, std::milli >(std::chrono::steady_clock::now() - start).count();
+            
+            std::cout << "computed " << std::max(samples, 1u) << " samples in " << milliseconds << " ms" << std::endl;
+            std::cout << "resulting spectrum is ";
+            list_print(std::cout, spectrum.begin(), spectrum.end());
+            std::cout << std::endl;
+        }
+        else if (command.compare("homology") == 0)
+        {
+            MovableComplex parsed;
+            unsigned int handle;
+            std::string error;
+            MovableComplex * loaded = sessions.read(line, sstream, in, parsed, handle, error);
+            if (loaded == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            MovableComplex & complex = *loaded;
+            
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            homology_list_t homology;
+            bool computed = complex_homology(complex, homology);
+            double milliseconds = std::chrono::duration< double, std::milli >(std::chrono::steady_clock::now() - start).count();
+            
+            std::cout << "computed homology in " << milliseconds << " ms" << std::endl;
+            if (computed)
+            {
+                std::cout << "resulting homology is ";
+                list_print(std::cout, homology.begin(), homology.end());
+                std::cout << std::endl;
+            }
+            else
+            {
+                std::cout << "resulting homology is fail" << std::endl;
+            }
+        }
+        else if (command.compare("ismanifold") == 0)
+        {
+            MovableComplex parsed;
+            unsigned int handle;
+            std::string error;
+            MovableComplex * loaded = sessions.read(line, sstream, in, parsed, handle, error);
+            if (loaded == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            MovableComplex & complex = *loaded;
+            
+            unsigned int rounds = 5000;
+            const ReductionSchedule * schedule = reduction_schedule("default");
+            unsigned int threads = std::thread::hardware_concurrency();
+            unsigned int seed = random_seed();
+            
+            std::string nextToken;
+            while (sstream >> nextToken)
+            {
+                std::stringstream token(nextToken);
+                
+                if (token.str().compare(0,6,"rounds") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> rounds;
+                }
+                else if (token.str().compare(0,8,"schedule") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    std::string name;
+                    token >> name;
+                    if (reduction_schedule(name) != 0)
+                        schedule = reduction_schedule(name);
+                    else
+                        std::cerr << "unknown schedule " << name << ", using the default schedule" << std::endl;
+                }
+                else if (token.str().compare(0,7,"threads") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> threads;
+                }
+                else if (token.str().compare(0,4,"seed") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> seed;
+                }
+            }
+            
+            link_verdict_list_t verdicts;
+            manifold_verdict_t verdict = recognize_manifold(complex, rounds, *schedule, threads, seed, verdicts);
+            for (link_verdict_list_t::const_iterator it = verdicts.begin(); it != verdicts.end(); it++)
+            {
+                if (it->second == link_sphere)
+                    std::cout << "link of vertex " << it->first << " is sphere" << std::endl;
+                else if (it->second == link_unknown)
+                    std::cout << "link of vertex " << it->first << " is unknown" << std::endl;
+                else if (it->second == link_not_sphere)
+                    std::cout << "link of vertex " << it->first << " is no sphere" << std::endl;
+            }
+            
+            if (verdict == manifold_true)
+                std::cout << "resulting manifold is true" << std::endl;
+            else if (verdict == manifold_false)
+                std::cout << "resulting manifold is false" << std::endl;
+            else
+                std::cout << "resulting manifold is unknown" << std::endl;
+        }
+        else if (command.compare("replay") == 0)
+        {
+            MovableComplex parsed;
+            unsigned int handle;
+            std::string error;
+            MovableComplex * loaded = sessions.read(line, sstream, in, parsed, handle, error);
+            if (loaded == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            MovableComplex & complex = *loaded;
+            
+            std::string tracePath;
+            std::string nextToken;
+            while (sstream >> nextToken)
+            {
+                std::stringstream token(nextToken);
+                
+                if (token.str().compare(0,5,"trace") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> tracePath;
+                }
+            }
+            
+            bistellar_move_list_t moves;
+            if (!MoveTrace::read(tracePath, moves))
+            {
+                std::cout << "could not read trace file " << tracePath << std::endl;
+                continue;
+            }
+            
+            // the replay stops at the first move which is not valid in the complex reached so far
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            size_t replayed = 0;
+            while (replayed < moves.size() && complex.moveComplex(moves[replayed]))
+                replayed++;
+            double milliseconds = std::chrono::duration< double, std::milli >(std::chrono::steady_clock::now() - start).count();
+            
+            if (replayed < moves.size())
+                std::cout << "move " << replayed+1 << " of the trace is not valid, stopped after " << replayed << " of " << moves.size() << " moves" << std::endl;
+            std::cout << "replayed " << replayed << " moves in " << milliseconds << " ms" << std::endl;
+            if (handle != 0)
+                std::cout << "resulting handle is " << handle << " with " << complex.f(0) << " vertices" << std::endl;
+            else
+                std::cout << "resulting complex is " << complex << " with " << complex.f(0) << " vertices" << std::endl;
+        }
+        else if (command.compare("load") == 0)
+        {
+            MovableComplex complex;
+            std::string error;
+            if (!read_complex(line, sstream, in, complex, error))
+            {
+                std::cout << "malformed complex: " << error << std::endl;
+                continue;
+            }
+            
+            unsigned int vertices = complex.f(0);
+            std::cout << "resulting handle is " << sessions.load(std::move(complex)) << " with " << vertices << " vertices" << std::endl;
+        }
+        else if (command.compare("dump") == 0)
+        {
+            MovableComplex parsed;
+            unsigned int handle;
+            std::string error;
+            MovableComplex * loaded = sessions.read(line, sstream, in, parsed, handle, error);
+            if (loaded == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            
+            std::cout << "resulting complex is " << *loaded << " with " << loaded->f(0) << " vertices" << std::endl;
+        }
+        else if (command.compare("free") == 0)
+        {
+            unsigned int handle = 0;
+            sstream >> handle;
+            
+            if (sessions.free(handle))
+                std::cout << "freed handle " << handle << std::endl;
+            else
+                std::cout << "unknown handle " << handle << std::endl;
+        }
+        else if (command.compare("fvector") == 0)
+        {
+            MovableComplex parsed;
+            unsigned int handle;
+            std::string error;
+            MovableComplex * loaded = sessions.read(line, sstream, in, parsed, handle, error);
+            if (loaded == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            MovableComplex & complex = *loaded;
+            
+            std::vector< unsigned int > fVector;
+            for (unsigned int d = 0; d < complex.dimension()+1; d++)
+                fVector.push_back(complex.f(d));
+            
+            std::cout << "resulting fvector is ";
+            list_print(std::cout, fVector.begin(), fVector.end());
+            std::cout << std::endl;
+        }
+        else if (command.compare("moves") == 0)
+        {
+            MovableComplex parsed;
+            unsigned int handle;
+            std::string error;
+            MovableComplex * loaded = sessions.read(line, sstream, in, parsed, handle, error);
+            if (loaded == 0)
+            {
+                std::cout << error << std::endl;
+                continue;
+            }
+            MovableComplex & complex = *loaded;
+            
+            // the number of valid moves of every codimension
+            std::vector< unsigned int > moves;
+            for (unsigned int i = 0; i < complex.dimension()+1; i++)
+                moves.push_back(complex.numberOfValidMoves(i));
+            
+            std::cout << "resulting moves are ";
+            list_print(std::cout, moves.begin(), moves.end());
+            std::cout << std::endl;
+        }
+        else if (command.compare("benchmark") == 0)
+        {
+            unsigned int facets = 1000000;
+            unsigned int dimension = 3;
+            unsigned int seed = random_seed();
+            std::string output = "/dev/null";
+            
+            std::string nextToken;
+            while (sstream >> nextToken)
+            {
+                std::stringstream token(nextToken);
+                
+                if (token.str().compare(0,6,"facets") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> facets;
+                }
+                else if (token.str().compare(0,6,"output") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> output;
+                }
+                else if (token.str().compare(0,9,"dimension") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> dimension;
+                }
+                else if (token.str().compare(0,4,"seed") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> seed;
+                }
+            }
+            
+            benchmark_io(std::cout, facets, dimension, seed, output);
+        }
+        else if (command.compare("batch") == 0)
+        {
+            BatchOptions options;
+            options.seed = random_seed();
+            
+            std::string name, path;
+            sstream >> name >> path;
+            if (!batch_operation(name, options.operation))
+            {
+                std::cout << "unknown operation " << name << std::endl;
+                continue;
+            }
+            if (options.operation == batch_ismanifold)
+                options.rounds = 5000;
+            
+            std::string nextToken;
+            while (sstream >> nextToken)
+            {
+                std::stringstream token(nextToken);
+                
+                if (token.str().compare(0,6,"rounds") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> options.rounds;
+                }
+                else if (token.str().compare(0,7,"heating") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> options.heating;
+                }
+                else if (token.str().compare(0,10,"relaxation") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> options.relaxation;
+                }
+                else if (token.str().compare(0,8,"schedule") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    std::string scheduleName;
+                    token >> scheduleName;
+                    if (reduction_schedule(scheduleName) != 0)
+                        options.schedule = reduction_schedule(scheduleName);
+                    else
+                        std::cerr << "unknown schedule " << scheduleName << ", using the default schedule" << std::endl;
+                }
+                else if (token.str().compare(0,7,"threads") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> options.threads;
+                }
+                else if (token.str().compare(0,4,"seed") == 0)
+                {
+                    token.ignore(token.str().length(),'=');
+                    token >> options.seed;
+                }
+            }
+            
+            std::vector< std::string > files;
+            std::string error;
+            if (!list_library(path, files, error))
+            {
+                std::cout << error << std::endl;
+                continue;
             }
             
-            reduce_complex(complex, rounds, heating, relaxation);
+            // complexes of an index are named relative to its directory, those of a directory relative to it
+            std::string root = path;
+            if (!root.empty() && root[root.size()-1] == '/')
+                root.erase(root.size()-1);
+            if (root.size() > 5 && root.compare(root.size()-5, 5, ".idxb") == 0)
+                root = root.find('/') == std::string::npos ? std::string(".") : root.substr(0, root.find_last_of('/'));
             
-            std::cout << "resulting complex is " << complex << " with " << complex.f(0) << " vertices" << std::endl;
+            batch_complexes(files, root, options, std::cout);
         }
         else if (command.compare("quit") == 0)
         {
@@ -107,8 +882,55 @@ int main (int argc, const char * argv[])
             std::cout << "possible commands are:" << std::endl;
             std::cout << "- \"reduce %c with %o\", where %c is a complex given as facet list and %o are options." << std::endl;
             std::cout << "\texample: \"reduce [[1,2],[2,3],[3,4],[4,1]] with rounds=10, heating=0 and relaxation=4\"" << std::endl;
+            std::cout << "\tthreads=N runs N independent chains in parallel and returns the best result, abandon=K stops chains" << std::endl;
+            std::cout << "\twhose best complex has more than K vertices more than the best of all chains." << std::endl;
+            std::cout << "\tschedule=%s selects how moves are chosen: default, scaled (which also heats in dimension 6 and up) or descent." << std::endl;
+            std::cout << "\ttabu=N skips moves leading back into one of the last N states of a chain and reports how many were skipped." << std::endl;
             std::cout << "- \"randomize %c with %o\", where %c is a complex given as facet list and %o are options." << std::endl;
             std::cout << "\texample: \"randomize [[1,2,3],[1,2,4],[1,3,4],[2,3,4]] with rounds=10 and allowedMoves=[0,1]\"" << std::endl;
+            std::cout << "- both commands accept the options seed=N, which seeds the random number generator, trace=%f, which writes" << std::endl;
+            std::cout << "\tthe applied moves to the file %f, and relabel=true, which relabels the vertices of the result to 1..n." << std::endl;
+            std::cout << "\tout=%f writes the result to the file %f in the binary format instead of returning it." << std::endl;
+            std::cout << "- \"temper %c with %o\", which reduces the complex %c by replica exchange. Options are rounds, replicas," << std::endl;
+            std::cout << "\ttmin and tmax (the temperature range, by default d/2 to 2*d), exchange (the moves between exchanges), threads, seed, target and relabel." << std::endl;
+            std::cout << "\texample: \"temper [[1,2],[2,3],[3,4],[4,1]] with rounds=1000, replicas=8 and target=3\"" << std::endl;
+            std::cout << "- \"equivalent %c and %d with %o\", which searches bistellar moves transforming %c into a complex isomorphic to %d." << std::endl;
+            std::cout << "\tThe result is true, false (dimension or Euler characteristic differ) or unknown after rounds moves. Options are" << std::endl;
+            std::cout << "\trounds, schedule, heating, relaxation, seed and trace=%f, which writes the moves to %f if the result is true." << std::endl;
+            std::cout << "\texample: \"equivalent [[1,2],[2,3],[3,4],[4,1]] and [[1,2],[2,3],[3,1]] with rounds=100\"" << std::endl;
+            std::cout << "- \"isosig %c\", which computes the isomorphism signature of the closed, strongly connected pseudomanifold %c" << std::endl;
+            std::cout << "\tas SCExportIsoSig does, or fail if %c is none." << std::endl;
+            std::cout << "- \"homology %c\", which computes the reduced integral homology [H_0,...,H_d] of %c in the format of SCHomology" << std::endl;
+            std::cout << "\tand the time it took." << std::endl;
+            std::cout << "- \"collapse %c with %o\", which collapses %c greedily as SCCollapseGreedy and returns the maximal faces left." << std::endl;
+            std::cout << "- \"morsespec %c with %o\", which computes random discrete Morse functions of %c and returns how often every" << std::endl;
+            std::cout << "\tvector of critical faces occurred, as SCMorseSpec. Options are samples (100 by default), threads and seed." << std::endl;
+            std::cout << "- both commands accept order=random, lex or revlex, the order of SCMorseRandom, SCMorseRandomLex or SCMorseRandomRevLex." << std::endl;
+            std::cout << "- \"ismanifold %c with %o\", which tests if the links of all vertices of %c are spheres by reducing them to the" << std::endl;
+            std::cout << "\tboundary of a simplex, and prints the verdict of every link checked. The result is true, false (a link is no" << std::endl;
+            std::cout << "\tconnected closed pseudomanifold) or unknown. The test stops at the first link not recognized as a sphere." << std::endl;
+            std::cout << "\tOptions are rounds (the moves per link, 5000 by default), schedule, threads and seed." << std::endl;
+            std::cout << "- \"replay %c with trace=%f\", which applies the moves recorded in the trace file %f to the complex %c." << std::endl;
+            std::cout << "\tThe replay stops at the first move which is not valid, and reports its position in the trace." << std::endl;
+            std::cout << "- \"load %c\", which keeps the complex %c in this session and returns a handle to it. Every command accepts" << std::endl;
+            std::cout << "\ta handle in place of a complex. reduce, randomize, temper and replay change the complex of the handle" << std::endl;
+            std::cout << "\tand return the handle with its number of vertices instead of the facets." << std::endl;
+            std::cout << "\texample: \"load [[1,2],[2,3],[3,4],[4,1]]\", then \"reduce 1 with rounds=10\" and \"dump 1\"" << std::endl;
+            std::cout << "- every command accepts file=%f in place of a complex, which reads the complex from the file %f as facet list" << std::endl;
+            std::cout << "\tor in the binary format, and binary=N, when the complex follows the command line as N bytes in the binary format." << std::endl;
+            std::cout << "\tThe binary format is \"SCB1\", the dimension, the number of facets and the lexicographically sorted facets" << std::endl;
+            std::cout << "\tas varints, the vertices of each facet delta-encoded." << std::endl;
+            std::cout << "- \"dump %h\", which returns the complex of the handle %h, and \"free %h\", which removes it from the session." << std::endl;
+            std::cout << "- \"fvector %c\" and \"moves %c\", which return the f-vector and the number of valid moves of every codimension." << std::endl;
+            std::cout << "- \"benchmark with facets=N and dimension=D\", which measures how fast a random list of N facets of dimension D" << std::endl;
+            std::cout << "\tis parsed, by the generic stream reader and by the facet list parser used for all commands, and how" << std::endl;
+            std::cout << "\tfast it is written to the file given by output=%f (/dev/null by default), flushed per element and buffered." << std::endl;
+            std::cout << "- \"batch %n %p with %o\", which applies the operation %n (reduce, ismanifold, homology, isosig or fvector)" << std::endl;
+            std::cout << "\tto every complex of the library %p, a directory searched for files *.scb or an index file complexes.idxb." << std::endl;
+            std::cout << "\tThe complexes are processed in parallel, largest first, and a record with the result and the time taken" << std::endl;
+            std::cout << "\tis returned for each as soon as it is done, followed by the total throughput. Options are rounds, schedule," << std::endl;
+            std::cout << "\theating, relaxation, threads (one complex per thread) and seed." << std::endl;
+            std::cout << "\texample: \"batch ismanifold complexes/manifolds/3Manifolds with rounds=1000 and threads=8\"" << std::endl;
             std::cout << "- \"quit\"" << std::endl;
         }
     }
@@ -10,14 +10,29 @@
 #include "face.h"
 #include "util.h"
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 
-MovableComplex::MovableComplex() : _faces(1, face_list_t(0)), _moves(1, bistellar_move_option_list_t(0)), _dimension(0)
+// source of the journal ids of all complexes, 0 is never used
+static std::atomic< unsigned long long > nextJournalId(1);
+
+// the key of a facet in the hash of the facet set: the hash of its vertices, scrambled by the splitmix64 finalizer
+static unsigned long long facetKey(const Face & facet)
 {
+    unsigned long long key = static_cast< unsigned long long >(facet.hash());
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
 }
 
-MovableComplex::MovableComplex(const face_list_t & facets, unsigned int dimension) : _faces(dimension+1), _moves(dimension+1), _dimension(dimension)
+MovableComplex::MovableComplex() : _memory(new ComplexMemory), _dimension(0)
 {
+    initStorage(0);
+}
+
+MovableComplex::MovableComplex(const face_list_t & facets, unsigned int dimension) : _memory(new ComplexMemory), _dimension(dimension)
+{
+    initStorage(dimension);
     
     #ifdef Bistellar_debug_output
     std::cout << "Creating "<< dimension <<"-dimensional MovableComplex from Facets: ";
@@ -26,63 +41,58 @@ MovableComplex::MovableComplex(const face_list_t & facets, unsigned int dimensio
     #endif
     
     // init facets
-    _faces[dimension] = facets;
+    for (face_list_t::const_iterator it = facets.begin(); it != facets.end(); it++)
+        addFace(*it);
     
     // init lower dimensional faces
     for (int codimension = 1; codimension < dimension+1; codimension++)
     {
         if(!_faces[dimension - codimension + 1].empty())
         {
-            for (face_list_t::const_iterator it = _faces[dimension - codimension + 1].begin();
+            for (face_set_t::const_iterator it = _faces[dimension - codimension + 1].begin();
              it != _faces[dimension - codimension + 1].end(); it++)
             {
                 for (int i = 0; i < dimension - codimension + 2; i++)
                 {
-                    Face * boundaryFace = it->createBoundaryFace(i);
-                    // only add boundaryFace if it is not already contained in complex
-                    if (std::find(_faces[dimension - codimension].begin(), _faces[dimension - codimension].end(), *boundaryFace) == _faces[dimension - codimension].end())
-                    {
-                        _faces[dimension - codimension].push_back(*boundaryFace);
-                    }
-                    
-                    delete boundaryFace;
+                    // boundaryFace is only added if it is not already contained in complex
+                    _faces[dimension - codimension].insert(it->boundaryFace(i));
                 }
             }
         }
     }
     
+    // init the largest vertex label
+    for (face_set_t::const_iterator it = _faces[0].begin(); it != _faces[0].end(); it++)
+    {
+        if (vertex_t_compare(&_largestVertex, &(it->vertex(0))) < 0)
+            _largestVertex = it->vertex(0);
+    }
+    
     // init moves
     if (!_faces[dimension].empty())
     {
-        for (face_list_t::const_iterator it = _faces[dimension].begin(); it != _faces[dimension].end(); it++)
+        for (face_set_t::const_iterator it = _faces[dimension].begin(); it != _faces[dimension].end(); it++)
         {
             // add all 0-moves
-            _moves[0].push_back(std::make_pair(BistellarMove(*it, Face()), true));
+            addMove(BistellarMove(*it, Face()));
         }
     }
     for (int codimension = 1; codimension < dimension+1; codimension++)
     {
         if (!_faces[dimension-codimension].empty())
         {
-            for (face_list_t::const_iterator it = _faces[dimension-codimension].begin(); it != _faces[dimension-codimension].end(); it++)
+            for (face_set_t::const_iterator it = _faces[dimension-codimension].begin(); it != _faces[dimension-codimension].end(); it++)
             {
-                std::deque< Face > linkFacets;
+                face_list_t linkFacets(_memory->pool());
                 // copy all Facets that contain (*it) as a subface to linkFacets
-                if (!_faces[dimension].empty())
-                {
-                    for (face_list_t::const_iterator it2 = _faces[dimension].begin(); it2 != _faces[dimension].end(); it2++)
-                    {
-                        if (it->isSubfaceOf(*it2))
-                            linkFacets.push_back(*it2);
-                    }
-                }
+                collectStar(*it, linkFacets);
                 
                 if (linkFacets.size() == codimension+1)
                 {
                     // add the move option.
                     Face linkFace = Face::linkFace(*it, linkFacets);
                     if (linkFace.dimension() <= _dimension)
-                        _moves[codimension].push_back(std::make_pair(BistellarMove(*it, linkFace), (std::find(_faces[linkFace.dimension()].begin(), _faces[linkFace.dimension()].end(), linkFace) == _faces[linkFace.dimension()].end())));
+                        addMove(BistellarMove(*it, linkFace));
                 }
             }
         }
@@ -98,11 +108,13 @@ MovableComplex::MovableComplex(const face_list_t & facets, unsigned int dimensio
     #endif
 }
 
-MovableComplex::MovableComplex(const MovableComplex & cpy)
+MovableComplex::MovableComplex(const ComplexSnapshot & snapshot) : MovableComplex(face_list_t(snapshot._facets.begin(), snapshot._facets.end()), snapshot._dimension)
 {
-    _dimension = cpy._dimension;
-    _faces = cpy._faces;
-    _moves = cpy._moves;
+}
+
+MovableComplex::MovableComplex(const MovableComplex & cpy) : _memory(new ComplexMemory)
+{
+    copyFrom(cpy);
 }
 
 MovableComplex & MovableComplex::operator=(const MovableComplex & cpy)
@@ -110,13 +122,43 @@ MovableComplex & MovableComplex::operator=(const MovableComplex & cpy)
     if (this == &cpy)
         return *this;
     
-    _dimension = cpy._dimension;
-    _faces = cpy._faces;
-    _moves = cpy._moves;
+    copyFrom(cpy);
+    
+    return *this;
+}
+
+MovableComplex::MovableComplex(MovableComplex && other) : _memory(new ComplexMemory), _dimension(0)
+{
+    initStorage(0);
+    swap(other);
+}
+
+MovableComplex & MovableComplex::operator=(MovableComplex && other)
+{
+    swap(other);
     
     return *this;
 }
 
+void MovableComplex::swap(MovableComplex & other)
+{
+    // the containers are swapped together with their allocators, so they stay with the memory they live in
+    std::swap(_memory, other._memory);
+    std::swap(_dimension, other._dimension);
+    _faces.swap(other._faces);
+    _moves.swap(other._moves);
+    _validMoves.swap(other._validMoves);
+    _movesByLink.swap(other._movesByLink);
+    _vertexStars.swap(other._vertexStars);
+    _journal.swap(other._journal);
+    std::swap(_journalId, other._journalId);
+    std::swap(_largestVertex, other._largestVertex);
+    _freeVertices.swap(other._freeVertices);
+    std::swap(_hash, other._hash);
+    _undoLog.swap(other._undoLog);
+    std::swap(_logging, other._logging);
+}
+
 MovableComplex::~MovableComplex()
 {
 }
@@ -134,40 +176,144 @@ unsigned int MovableComplex::f(unsigned int d) const
     return 0;
 }
 
+const face_set_t & MovableComplex::faces(unsigned int d) const
+{
+    return _faces[d];
+}
+
 bool MovableComplex::hasValidMoves(unsigned int codimension) const
 {
-    if (!_moves[codimension].empty())
-    {
-        for (bistellar_move_option_list_t::const_iterator it = _moves[codimension].begin(); it != _moves[codimension].end(); it++)
-        {
-            if(it->second)
-                return true;
-        }
-    }
+    return !_validMoves[codimension].empty();
+}
 
-    return false;
+unsigned int MovableComplex::numberOfValidMoves(unsigned int codimension) const
+{
+    return static_cast< unsigned int >(_validMoves[codimension].size());
 }
 
 bistellar_move_list_t MovableComplex::validMoves(unsigned int codimension) const
 {
     bistellar_move_list_t validMoves;
-    if (!_moves[codimension].empty())
+    for (valid_move_list_t::const_iterator it = _validMoves[codimension].begin(); it != _validMoves[codimension].end(); it++)
+        validMoves.push_back((*it)->second.first);
+    
+    return validMoves;
+}
+
+const BistellarMove & MovableComplex::validMove(unsigned int codimension, unsigned int i) const
+{
+    return _validMoves[codimension][i]->second.first;
+}
+
+BistellarMove MovableComplex::randomValidMove(unsigned int codimension, random_engine_t & rng) const
+{
+    return validMove(codimension, rng() % _validMoves[codimension].size());
+}
+
+unsigned long long MovableComplex::hash() const
+{
+    return _hash;
+}
+
+unsigned long long MovableComplex::hashAfter(const BistellarMove & move) const
+{
+    unsigned long long hash = _hash;
+    
+    if (move.codimension() == 0)
     {
-        for (bistellar_move_option_list_t::const_iterator it = _moves[codimension].begin(); it != _moves[codimension].end(); it++)
+        Face newVertex = move.link();
+        if (newVertex.dimension() < 0)
         {
-            if(it->second)
-                validMoves.push_back(it->first);
+            vertex_t label = nextVertexLabel();
+            newVertex = Face(&label, 0);
         }
+        
+        hash ^= facetKey(move.face());
+        for (int i = 0; i < move.face().dimension()+1; i++)
+            hash ^= facetKey(Face::unite(move.face().boundaryFace(i), newVertex));
     }
-    return validMoves;
+    else
+    {
+        // face*∂link is replaced by ∂face*link
+        for (int i = 0; i < move.link().dimension()+1; i++)
+            hash ^= facetKey(Face::unite(move.face(), move.link().boundaryFace(i)));
+        
+        if (move.face().dimension() == 0)
+        {
+            hash ^= facetKey(move.link());
+        }
+        else
+        {
+            for (int i = 0; i < move.face().dimension()+1; i++)
+                hash ^= facetKey(Face::unite(move.face().boundaryFace(i), move.link()));
+        }
+    }
+    
+    return hash;
 }
 
-void MovableComplex::moveComplex(const BistellarMove & move)
+bool MovableComplex::moveComplex(const BistellarMove & move)
 {
-    face_list_t::iterator faceIt = std::find(_faces[move.dimension()].begin(), _faces[move.dimension()].end(), move.face());
-    bistellar_move_option_list_t::iterator moveIt = std::find(_moves[move.codimension()].begin(), _moves[move.codimension()].end(), std::make_pair(move, true));
+    BistellarMove inverse;
+    bool applied = applyMove(move, inverse);
+    if (applied && _logging)
+        _undoLog.push_back(inverse);
+    
+    // all temporary lists of the move are gone, so the scratch arena can be reset
+    _memory->releaseScratch();
     
-    if (faceIt != _faces[move.dimension()].end() && moveIt != _moves[move.codimension()].end() && moveIt->second)
+    return applied;
+}
+
+BistellarMove MovableComplex::resolvedMove(const BistellarMove & move) const
+{
+    if (move.codimension() != 0 || move.link().dimension() >= 0)
+        return move;
+    
+    vertex_t label = nextVertexLabel();
+    return BistellarMove(move.face(), Face(&label, 0));
+}
+
+size_t MovableComplex::checkpoint()
+{
+    _logging = true;
+    return _undoLog.size();
+}
+
+void MovableComplex::rollback(size_t checkpoint)
+{
+    while (_undoLog.size() > checkpoint)
+    {
+        BistellarMove inverse;
+        applyMove(_undoLog.back(), inverse);
+        _undoLog.pop_back();
+        _memory->releaseScratch();
+    }
+}
+
+void MovableComplex::commit()
+{
+    _undoLog.clear();
+    _logging = false;
+}
+
+size_t MovableComplex::numberOfLoggedMoves() const
+{
+    return _undoLog.size();
+}
+
+bool MovableComplex::applyMove(const BistellarMove & move, BistellarMove & inverse)
+{
+    ResourceAllocator< Face > scratch(_memory->scratch());
+    
+    face_set_t::iterator faceIt = _faces[move.dimension()].find(move.face());
+    bistellar_move_option_map_t::iterator moveIt = _moves[move.codimension()].find(move.face());
+    
+    // a move of codimension 0 may name its new vertex as link, which must not be a vertex yet
+    bool isMoveOption = moveIt != _moves[move.codimension()].end()
+        && (moveIt->second.first == move || (move.codimension() == 0 && _faces[0].count(move.link()) == 0));
+    
+    if (faceIt != _faces[move.dimension()].end() && isMoveOption && moveIt->second.second != invalid_move_position)
     {
         #ifdef Bistellar_debug_output
         std::cout << "Applying " << move << " to complex ";
@@ -177,26 +323,22 @@ void MovableComplex::moveComplex(const BistellarMove & move)
         if (move.codimension() == 0)
         {
             // remove face*∂link
-            _faces[move.dimension()].erase(faceIt);
-            _moves[move.codimension()].erase(moveIt);
+            removeFace(move.face());
+            removeMove(move.codimension(), move.face());
             
             // add ∂face*link
-            vertex_t largestVertex = 0;
-            if (!_faces[0].empty())
+            Face newVertex = move.link();
+            if (newVertex.dimension() < 0)
             {
-                for (face_list_t::const_iterator it = _faces[0].begin(); it != _faces[0].end(); it++)
-                {
-                    if (vertex_t_compare(&largestVertex, &(it->vertex(0))) < 0)
-                        largestVertex = it->vertex(0);
-                }
+                vertex_t label = newVertexLabel();
+                newVertex = Face(&label, 0);
             }
-            largestVertex++;
-            Face newVertex(&largestVertex, 0);
-            _faces[0].push_back(newVertex);
+            addFace(newVertex);
+            inverse = BistellarMove(newVertex, move.face());
             
-            face_list_t listOfSubfaces;
+            face_list_t listOfSubfaces(scratch);
             addSubfacesOfFace(move.face(), listOfSubfaces);
-            face_list_t listOfBoundaryfaces;
+            face_list_t listOfBoundaryfaces(scratch);
             addBoundaryfacesOfFace(move.face(), listOfBoundaryfaces);
             if (!listOfSubfaces.empty())
             {
@@ -204,83 +346,75 @@ void MovableComplex::moveComplex(const BistellarMove & move)
                 {
                     Face newFace = Face::unite(*it, newVertex);
                     // add new face to complex
-                    _faces[newFace.dimension()].push_back(newFace);
+                    addFace(newFace);
                     
                     // add new move options
                     if (newFace.dimension() == this->dimension())
                     {
-                        _moves[0].push_back(std::make_pair(BistellarMove(newFace, Face()), true));
+                        addMove(BistellarMove(newFace, Face()));
                     }
                     else
                     {
-                        face_list_t listOfLinkFaces;
+                        // the facets containing newFace are the cones over the boundary faces containing (*it)
+                        face_list_t listOfLinkFaces(scratch);
                         for (face_list_t::iterator it2 = listOfBoundaryfaces.begin(); it2 != listOfBoundaryfaces.end(); it2++)
                         {
                             if (it->isSubfaceOf(*it2))
-                                listOfLinkFaces.push_back(*it2);
+                                listOfLinkFaces.push_back(Face::unite(*it2, newVertex));
                         }
-                        if (listOfLinkFaces.size() == this->dimension() - it->dimension() + 1)
+                        if (listOfLinkFaces.size() == this->dimension() - newFace.dimension() + 1)
                         {
-                            Face linkFace = Face::linkFace(*it, listOfLinkFaces);
+                            Face linkFace = Face::linkFace(newFace, listOfLinkFaces);
                             if (linkFace.dimension() <= this->dimension())
-                                _moves[this->dimension() - it->dimension()].push_back(std::make_pair(BistellarMove(*it, linkFace), false));
+                                addMove(BistellarMove(newFace, linkFace));
                         }
                     }
                 }
                 updateBallBoundary(*this, listOfSubfaces);
             }
+            
+            // the new vertex can be removed by the inverse move right away
+            addMove(inverse);
         }
         else
         {
+            // the link becomes the face of the move and vice versa
+            inverse = BistellarMove(move.link(), move.face());
+            
             // remove face*∂link
-            face_list_t listOfLinkSubfaces;
+            face_list_t listOfLinkSubfaces(scratch);
             addSubfacesOfFace(move.link(), listOfLinkSubfaces);
             
-            _faces[move.dimension()].erase(faceIt);
-            _moves[move.codimension()].erase(moveIt);
+            removeFace(move.face());
+            removeMove(move.codimension(), move.face());
             if (!listOfLinkSubfaces.empty())
             {
                 for (face_list_t::iterator it = listOfLinkSubfaces.begin(); it != listOfLinkSubfaces.end(); it++)
                 {
                     // remove old faces
                     Face oldFace = Face::unite(move.face(), *it);
-                    face_list_t::iterator oldFaceIt = std::find(_faces[oldFace.dimension()].begin(), _faces[oldFace.dimension()].end(), oldFace);
-                    if (oldFaceIt != _faces[oldFace.dimension()].end())
-                        _faces[oldFace.dimension()].erase(oldFaceIt);
+                    removeFace(oldFace);
                     
                     // remove old moves
-                    if (!_moves[this->dimension() - oldFace.dimension()].empty())
-                    {
-                        for (bistellar_move_option_list_t::iterator oldMoveIt = _moves[this->dimension() - oldFace.dimension()].begin(); oldMoveIt != _moves[this->dimension() - oldFace.dimension()].end(); oldMoveIt++)
-                        {
-                            if (oldMoveIt->first.face() == oldFace)
-                            {
-                                _moves[this->dimension() - oldFace.dimension()].erase(oldMoveIt);
-                                break;
-                            }
-                        }
-                    }
+                    removeMove(this->dimension() - oldFace.dimension(), oldFace);
                 }
             }
             
             // add ∂face*link
-            face_list_t listOfFaceSubfaces;
+            face_list_t listOfFaceSubfaces(scratch);
             addSubfacesOfFace(move.face(), listOfFaceSubfaces);
             listOfFaceSubfaces.push_back(Face());
             if (!listOfFaceSubfaces.empty())
             {
-                face_list_t listOfNewFacets;
-                face_list_t listOfBallInteriorFaces;
+                face_list_t listOfNewFacets(scratch);
+                face_list_t listOfBallInteriorFaces(scratch);
                 
                 // add the new faces                
                 for (face_list_t::iterator it = listOfFaceSubfaces.begin(); it != listOfFaceSubfaces.end(); it++)
                 {
                     Face newFace = Face::unite(*it, move.link());
 
-                    if (_faces[newFace.dimension()].empty() || std::find(_faces[newFace.dimension()].begin(), _faces[newFace.dimension()].end(), newFace) == _faces[newFace.dimension()].end())
-                    {
-                        _faces[newFace.dimension()].push_back(newFace);
-                    }
+                    addFace(newFace);
 
                     if (newFace.dimension() == this->dimension())
                     {
@@ -298,11 +432,11 @@ void MovableComplex::moveComplex(const BistellarMove & move)
                     Face newFace = Face::unite(*it, move.link());
                     if (newFace.dimension() == this->dimension())
                     {
-                        _moves[0].push_back(std::make_pair(BistellarMove(newFace, Face()),true));
+                        addMove(BistellarMove(newFace, Face()));
                     }
                     else
                     {
-                        face_list_t listOfLinkFaces;
+                        face_list_t listOfLinkFaces(scratch);
                         for (face_list_t::iterator it2 = listOfNewFacets.begin(); it2 != listOfNewFacets.end(); it2++)
                         {
                             if (newFace.isSubfaceOf(*it2))
@@ -312,17 +446,17 @@ void MovableComplex::moveComplex(const BistellarMove & move)
                         {
                             Face linkFace = Face::linkFace(newFace, listOfLinkFaces);
                             if (linkFace.dimension() <= this->dimension())
-                                _moves[this->dimension() - newFace.dimension()].push_back(std::make_pair(BistellarMove(newFace, linkFace), false));
+                                addMove(BistellarMove(newFace, linkFace));
                         }
                     }
                 }
                 
-                face_list_t listOfBallBounaryFaces;
+                face_list_t listOfBallBounaryFaces(scratch);
                 if (!listOfNewFacets.empty())
                 {
                     for (face_list_t::iterator it = listOfNewFacets.begin(); it != listOfNewFacets.end(); it++)
                     {
-                        face_list_t listOfNewFacetSubfaces;
+                        face_list_t listOfNewFacetSubfaces(scratch);
                         addSubfacesOfFace(*it, listOfNewFacetSubfaces);
                         if (!listOfNewFacetSubfaces.empty())
                         {
@@ -340,8 +474,6 @@ void MovableComplex::moveComplex(const BistellarMove & move)
             }
         }
         
-        updateMoveValidity(*this);
-        
         #ifdef Bistellar_debug_output
         std::cout << "Resulting complex is ";
         list_print(std::cout, _faces[_dimension].begin(), _faces[_dimension].end());
@@ -353,12 +485,310 @@ void MovableComplex::moveComplex(const BistellarMove & move)
             std::cout << std::endl;
         }
         #endif
+        return true;
     }
     else
     {
         #ifdef Bistellar_debug_output
         std::cout << move << " is not a valid move for the complex " << *this << std::endl;
         #endif
+        return false;
+    }
+}
+
+void MovableComplex::relabel()
+{
+    std::vector< vertex_t > vertices;
+    for (face_set_t::const_iterator it = _faces[0].begin(); it != _faces[0].end(); it++)
+        vertices.push_back(it->vertex(0));
+    std::sort(vertices.begin(), vertices.end());
+    
+    face_list_t facets;
+    std::vector< vertex_t > facetVertices(_dimension+1);
+    for (face_set_t::const_iterator it = _faces[_dimension].begin(); it != _faces[_dimension].end(); it++)
+    {
+        for (int i = 0; i < it->dimension()+1; i++)
+            facetVertices[i] = static_cast< vertex_t >(std::lower_bound(vertices.begin(), vertices.end(), it->vertex(i)) - vertices.begin()) + 1;
+        facets.push_back(Face(&facetVertices[0], _dimension));
+    }
+    
+    *this = MovableComplex(facets, _dimension);
+}
+
+void MovableComplex::snapshot(ComplexSnapshot & snapshot)
+{
+    if (_journalId != 0 && snapshot._journalId == _journalId)
+    {
+        for (face_count_map_t::const_iterator it = _journal.begin(); it != _journal.end(); it++)
+        {
+            if (it->second > 0)
+                snapshot._facets.insert(it->first);
+            else
+                snapshot._facets.erase(it->first);
+        }
+    }
+    else
+    {
+        snapshot._dimension = _dimension;
+        snapshot._facets = _faces[_dimension];
+    }
+    
+    _journal.clear();
+    _journalId = nextJournalId++;
+    snapshot._journalId = _journalId;
+}
+
+void MovableComplex::recordFacet(const Face & facet, int change)
+{
+    if (_journalId == 0)
+        return;
+    
+    face_count_map_t::iterator it = _journal.insert(std::make_pair(facet, 0)).first;
+    it->second += change;
+    if (it->second == 0)
+        _journal.erase(it);
+}
+
+vertex_t MovableComplex::nextVertexLabel() const
+{
+    for (std::vector< vertex_t >::const_reverse_iterator it = _freeVertices.rbegin(); it != _freeVertices.rend(); it++)
+    {
+        if (_faces[0].count(Face(&(*it), 0)) == 0)
+            return *it;
+    }
+    
+    return _largestVertex + 1;
+}
+
+vertex_t MovableComplex::newVertexLabel()
+{
+    while (!_freeVertices.empty())
+    {
+        vertex_t label = _freeVertices.back();
+        _freeVertices.pop_back();
+        if (_faces[0].count(Face(&label, 0)) == 0)
+            return label;
+    }
+    
+    return ++_largestVertex;
+}
+
+void MovableComplex::addFace(const Face & face)
+{
+    if (_faces[face.dimension()].insert(face).second)
+    {
+        setLinkValidity(face, false);
+        
+        if (face.dimension() == 0)
+        {
+            if (vertex_t_compare(&_largestVertex, &(face.vertex(0))) < 0)
+                _largestVertex = face.vertex(0);
+            // a vertex restored by a rollback usually is the last one freed
+            if (!_freeVertices.empty() && _freeVertices.back() == face.vertex(0))
+                _freeVertices.pop_back();
+        }
+        
+        if (face.dimension() == _dimension)
+        {
+            _hash ^= facetKey(face);
+            recordFacet(face, 1);
+            for (int i = 0; i < face.dimension()+1; i++)
+                vertexStar(face.vertex(i)).push_back(face);
+        }
+    }
+}
+
+void MovableComplex::removeFace(const Face & face)
+{
+    if (_faces[face.dimension()].erase(face) != 0)
+    {
+        setLinkValidity(face, true);
+        
+        if (face.dimension() == 0)
+            _freeVertices.push_back(face.vertex(0));
+        
+        if (face.dimension() == _dimension)
+        {
+            _hash ^= facetKey(face);
+            recordFacet(face, -1);
+            for (int i = 0; i < face.dimension()+1; i++)
+            {
+                vertex_star_map_t::iterator starIt = _vertexStars.find(face.vertex(i));
+                if (starIt == _vertexStars.end())
+                    continue;
+                
+                face_list_t::iterator it = std::find(starIt->second.begin(), starIt->second.end(), face);
+                if (it != starIt->second.end())
+                {
+                    *it = starIt->second.back();
+                    starIt->second.pop_back();
+                }
+                if (starIt->second.empty())
+                    _vertexStars.erase(starIt);
+            }
+        }
+    }
+}
+
+face_list_t & MovableComplex::vertexStar(vertex_t vertex)
+{
+    vertex_star_map_t::iterator starIt = _vertexStars.find(vertex);
+    if (starIt == _vertexStars.end())
+        starIt = _vertexStars.insert(std::make_pair(vertex, face_list_t(_memory->pool()))).first;
+    
+    return starIt->second;
+}
+
+void MovableComplex::collectStar(const Face & face, face_list_t & starFacets) const
+{
+    if (face.dimension() < 0)
+        return;
+    
+    // the star of face is the intersection of the stars of its vertices, so it suffices to filter the smallest one
+    const face_list_t * smallestStar = 0;
+    for (int i = 0; i < face.dimension()+1; i++)
+    {
+        vertex_star_map_t::const_iterator starIt = _vertexStars.find(face.vertex(i));
+        if (starIt == _vertexStars.end())
+            return;
+        if (smallestStar == 0 || starIt->second.size() < smallestStar->size())
+            smallestStar = &(starIt->second);
+    }
+    
+    for (face_list_t::const_iterator it = smallestStar->begin(); it != smallestStar->end(); it++)
+    {
+        if (face.isSubfaceOf(*it))
+            starFacets.push_back(*it);
+    }
+}
+
+void MovableComplex::initStorage(unsigned int dimension)
+{
+    _faces.clear();
+    _moves.clear();
+    for (unsigned int d = 0; d < dimension+1; d++)
+    {
+        _faces.push_back(face_set_t(_memory->pool()));
+        _moves.push_back(bistellar_move_option_map_t(_memory->pool()));
+    }
+    _validMoves.assign(dimension+1, valid_move_list_t());
+    _movesByLink = face_multimap_t(_memory->pool());
+    _vertexStars = vertex_star_map_t(_memory->pool());
+    _journal = face_count_map_t(_memory->pool());
+    _journalId = 0;
+    _largestVertex = 0;
+    _freeVertices.clear();
+    _hash = 0;
+    _undoLog.clear();
+    _logging = false;
+}
+
+void MovableComplex::copyFrom(const MovableComplex & cpy)
+{
+    // the containers keep allocating from this complex's pool, only their contents are copied
+    initStorage(cpy._dimension);
+    _dimension = cpy._dimension;
+    for (unsigned int d = 0; d < _dimension+1; d++)
+    {
+        _faces[d] = cpy._faces[d];
+        _moves[d] = cpy._moves[d];
+    }
+    _movesByLink = cpy._movesByLink;
+    _largestVertex = cpy._largestVertex;
+    _freeVertices = cpy._freeVertices;
+    _hash = cpy._hash;
+    
+    for (face_set_t::const_iterator it = _faces[_dimension].begin(); it != _faces[_dimension].end(); it++)
+    {
+        for (int i = 0; i < it->dimension()+1; i++)
+            vertexStar(it->vertex(i)).push_back(*it);
+    }
+    
+    rebuildValidMoves();
+}
+
+void MovableComplex::addMove(const BistellarMove & move)
+{
+    removeMove(move.codimension(), move.face());
+    
+    bistellar_move_option_map_t::value_type & option = *(_moves[move.codimension()].insert(std::make_pair(move.face(), std::make_pair(move, invalid_move_position))).first);
+    if (move.codimension() == 0)
+    {
+        setValidity(option, true);
+    }
+    else
+    {
+        setValidity(option, _faces[move.link().dimension()].count(move.link()) == 0);
+        _movesByLink.insert(std::make_pair(move.link(), move.face()));
+    }
+}
+
+void MovableComplex::removeMove(unsigned int codimension, const Face & face)
+{
+    bistellar_move_option_map_t::iterator moveIt = _moves[codimension].find(face);
+    if (moveIt == _moves[codimension].end())
+        return;
+    
+    if (codimension != 0)
+    {
+        std::pair< face_multimap_t::iterator, face_multimap_t::iterator > range = _movesByLink.equal_range(moveIt->second.first.link());
+        for (face_multimap_t::iterator it = range.first; it != range.second; it++)
+        {
+            if (it->second == face)
+            {
+                _movesByLink.erase(it);
+                break;
+            }
+        }
+    }
+    
+    setValidity(*moveIt, false);
+    _moves[codimension].erase(moveIt);
+}
+
+void MovableComplex::setLinkValidity(const Face & link, bool valid)
+{
+    if (link.dimension() < 1 || link.dimension() > _dimension)
+        return;
+    
+    std::pair< face_multimap_t::const_iterator, face_multimap_t::const_iterator > range = _movesByLink.equal_range(link);
+    for (face_multimap_t::const_iterator it = range.first; it != range.second; it++)
+        setValidity(*(_moves[link.dimension()].find(it->second)), valid);
+}
+
+void MovableComplex::setValidity(bistellar_move_option_map_t::value_type & option, bool valid)
+{
+    valid_move_list_t & validMoves = _validMoves[option.second.first.codimension()];
+    size_t & position = option.second.second;
+    
+    if (valid && position == invalid_move_position)
+    {
+        position = validMoves.size();
+        validMoves.push_back(&option);
+    }
+    else if (!valid && position != invalid_move_position)
+    {
+        // move the last valid move into the gap
+        validMoves[position] = validMoves.back();
+        validMoves[position]->second.second = position;
+        validMoves.pop_back();
+        position = invalid_move_position;
+    }
+}
+
+void MovableComplex::rebuildValidMoves()
+{
+    _validMoves.assign(_moves.size(), valid_move_list_t());
+    for (unsigned int codimension = 0; codimension < _moves.size(); codimension++)
+    {
+        for (bistellar_move_option_map_t::iterator it = _moves[codimension].begin(); it != _moves[codimension].end(); it++)
+        {
+            if (it->second.second != invalid_move_position)
+            {
+                it->second.second = _validMoves[codimension].size();
+                _validMoves[codimension].push_back(&(*it));
+            }
+        }
     }
 }
 
@@ -367,34 +797,15 @@ void updateBallBoundary(MovableComplex & complex, const face_list_t & ballBounda
 {
     if (!ballBoundaryFaces.empty())
     {
+        ResourceAllocator< Face > scratch(complex._memory->scratch());
         for (face_list_t::const_iterator it = ballBoundaryFaces.begin(); it != ballBoundaryFaces.end(); it++)
         {
-            face_list_t linkFacets;
+            face_list_t linkFacets(scratch);
             // copy all facets that contain (*it) as a subface to linkFacets
-            if (!complex._faces[complex._dimension].empty())
-            {
-                for (face_list_t::const_iterator it2 = complex._faces[complex._dimension].begin(); it2 != complex._faces[complex._dimension].end(); it2++)
-                {
-                    if (it->isSubfaceOf(*it2))
-                        linkFacets.push_back(*it2);
-                }
-            }
+            complex.collectStar(*it, linkFacets);
             
             // remove the move option with (*it) as face
-            if (!complex._moves[complex._dimension - it->dimension()].empty())
-            {
-                if (!complex._moves[complex._dimension - it->dimension()].empty())
-                {
-                    for (bistellar_move_option_list_t::iterator mIt = complex._moves[complex._dimension - it->dimension()].begin(); mIt != complex._moves[complex._dimension - it->dimension()].end(); mIt++)
-                    {
-                        if (mIt->first.face() == *it)
-                        {
-                            complex._moves[complex._dimension - it->dimension()].erase(mIt);
-                            break;
-                        }
-                    }
-                }
-            }
+            complex.removeMove(complex._dimension - it->dimension(), *it);
             
             
             if (linkFacets.size() == complex._dimension - it->dimension() + 1)
@@ -402,39 +813,23 @@ void updateBallBoundary(MovableComplex & complex, const face_list_t & ballBounda
                 // add the move option.
                 Face linkFace = Face::linkFace(*it, linkFacets);
                 if (linkFace.dimension() <= complex._dimension)
-                    complex._moves[complex._dimension - it->dimension()].push_back(std::make_pair(BistellarMove(*it, linkFace), (std::find(complex._faces[linkFace.dimension()].begin(), complex._faces[linkFace.dimension()].end(), linkFace) == complex._faces[linkFace.dimension()].end())));
+                    complex.addMove(BistellarMove(*it, linkFace));
             }
         }
     }
 }
-void updateMoveValidity(MovableComplex & complex)
-{
-    for (unsigned int i = 1; i < complex._dimension + 1; i++)
-    {
-        if (!complex._moves[i].empty())
-        {
-            for (bistellar_move_option_list_t::iterator it = complex._moves[i].begin(); it != complex._moves[i].end(); it++)
-                it->second = (std::find(complex._faces[it->first.link().dimension()].begin(), complex._faces[it->first.link().dimension()].end(), it->first.link()) == complex._faces[it->first.link().dimension()].end());
-        }
-    }
-}
-
 // serialization methods
 std::ostream & operator<< (std::ostream & os, const MovableComplex & complex)
 {
-    if (!complex._faces[complex._dimension].empty())
-    {
-        list_print(os ,complex._faces[complex._dimension].begin(), complex._faces[complex._dimension].end());
-    }
-    else
-    {
-        os << "[]";
-    }
+    // the facets are formatted into one buffer and written in one go
+    std::string & buffer = output_buffer();
+    write_list(buffer, complex._faces[complex._dimension].begin(), complex._faces[complex._dimension].end());
+    os.write(buffer.data(), buffer.size());
     return os;
 }
 std::istream & operator>> (std::istream & is, MovableComplex & complex)
 {
-    std::deque< Face > facets;
+    face_list_t facets;
     list_read(is, facets);
     
     if (facets.empty())
@@ -13,32 +13,130 @@ class MovableComplex;
 
 #include <vector>
 #include <iostream>
+#include <memory>
 #include "types.h"
 #include "face.h"
 #include "bistellar_move.h"
+#include "complex_snapshot.h"
 
 class MovableComplex
 {
+    // pool of the containers below and scratch arena of moveComplex
+    std::unique_ptr< ComplexMemory > _memory;
+    
     unsigned int _dimension;
     
-    std::vector< face_list_t > _faces;
-    std::vector< bistellar_move_option_list_t > _moves;
+    std::vector< face_set_t > _faces;
+    std::vector< bistellar_move_option_map_t > _moves;
+    // the valid moves of every codimension, pointing into _moves
+    std::vector< valid_move_list_t > _validMoves;
+    // maps the link of every move of codimension >= 1 to the face of the move
+    face_multimap_t _movesByLink;
+    // maps every vertex to the facets containing it
+    vertex_star_map_t _vertexStars;
+    // facets added (+1) or removed (-1) since the snapshot with id _journalId was taken.
+    // Facets are only recorded while _journalId != 0, i.e. after a snapshot has been taken.
+    face_count_map_t _journal;
+    unsigned long long _journalId;
+    // the largest vertex label in use so far and the labels of removed vertices, which are handed out again
+    // first. Labels are only checked when taken from _freeVertices, so it may contain vertices added since.
+    vertex_t _largestVertex;
+    std::vector< vertex_t > _freeVertices;
+    // Zobrist-style hash of the facet set, the XOR of the keys of all facets. Maintained by addFace and removeFace.
+    unsigned long long _hash;
+    
+    // the inverses of the moves applied since the first checkpoint, kept only while _logging is set
+    bistellar_move_list_t _undoLog;
+    bool _logging;
+    
+    // replaces all containers by empty ones allocating from the pool of the complex
+    void initStorage(unsigned int dimension);
+    // copies the faces and moves of cpy into the containers of the complex
+    void copyFrom(const MovableComplex & cpy);
+    // returns an unused vertex label, preferring labels of removed vertices
+    vertex_t newVertexLabel();
+    // returns the label the next call of newVertexLabel will return
+    vertex_t nextVertexLabel() const;
+    // returns the star list of vertex, creating it if necessary
+    face_list_t & vertexStar(vertex_t vertex);
+    // applies a valid move and sets inverse to the move undoing it. Returns false if the move is not valid.
+    // Temporary lists are allocated from the scratch arena.
+    bool applyMove(const BistellarMove & move, BistellarMove & inverse);
+    
+    // records an added (change = +1) or removed (change = -1) facet in the journal
+    void recordFacet(const Face & facet, int change);
+    // adds a face and invalidates all moves having it as link
+    void addFace(const Face & face);
+    // removes a face and validates all moves having it as link
+    void removeFace(const Face & face);
+    // adds a move option, its validity is derived from the current faces
+    void addMove(const BistellarMove & move);
+    // removes the move option of the given face
+    void removeMove(unsigned int codimension, const Face & face);
+    // sets the validity of all moves having link as link
+    void setLinkValidity(const Face & link, bool valid);
+    // sets the validity of a single move option and updates the list of valid moves
+    void setValidity(bistellar_move_option_map_t::value_type & option, bool valid);
+    // rebuilds the lists of valid moves from _moves, e.g. after copying
+    void rebuildValidMoves();
+    // adds all facets containing face to starFacets
+    void collectStar(const Face & face, face_list_t & starFacets) const;
     
 public:
     MovableComplex();
     MovableComplex(const face_list_t & facets, unsigned int dimension);
     
+    explicit MovableComplex(const ComplexSnapshot & snapshot);
+    
     MovableComplex(const MovableComplex & cpy);
     MovableComplex & operator=(const MovableComplex & cpy);
+    // moves are O(1), the moved-from complex is left with the former contents of the target (or empty).
+    MovableComplex(MovableComplex && other);
+    MovableComplex & operator=(MovableComplex && other);
+    void swap(MovableComplex & other);
     
     ~MovableComplex();
     
     unsigned int dimension() const;
     unsigned int f(unsigned int d) const;
+    // returns the faces of dimension d <= dimension()
+    const face_set_t & faces(unsigned int d) const;
     
     bool hasValidMoves(unsigned int codimension) const;
+    unsigned int numberOfValidMoves(unsigned int codimension) const;
     bistellar_move_list_t validMoves(unsigned int codimension) const;
-    void moveComplex(const BistellarMove & move);
+    // returns the i-th valid move of the given codimension, 0 <= i < numberOfValidMoves(codimension).
+    const BistellarMove & validMove(unsigned int codimension, unsigned int i) const;
+    // returns a valid move of the given codimension chosen uniformly at random. The codimension must have valid moves.
+    BistellarMove randomValidMove(unsigned int codimension, random_engine_t & rng) const;
+    // applies a valid move. A move of codimension 0 creates a new vertex, which reuses the label of a removed
+    // vertex or is the largest vertex plus one, or it is the vertex given as link of the move. Returns false and
+    // leaves the complex unchanged if the move is not valid.
+    bool moveComplex(const BistellarMove & move);
+    // returns the valid move with the vertex it creates as link if it is of codimension 0, i.e. the move which has
+    // the same effect on any complex with the same facets, whatever labels were handed out before
+    BistellarMove resolvedMove(const BistellarMove & move) const;
+    
+    // returns the hash of the facet set. Equal facet sets have equal hashes.
+    unsigned long long hash() const;
+    // returns the hash the facet set will have after applying the valid move, in time linear in the dimension.
+    unsigned long long hashAfter(const BistellarMove & move) const;
+    
+    // returns a checkpoint of the current state. From the first checkpoint on, every move is logged by its inverse.
+    size_t checkpoint();
+    // undoes all moves applied since checkpoint. Checkpoints taken after it become invalid.
+    void rollback(size_t checkpoint);
+    // keeps the current state, discards the log and all checkpoints and stops logging.
+    void commit();
+    // the number of moves a rollback to the first checkpoint would undo
+    size_t numberOfLoggedMoves() const;
+    
+    // relabels the vertices to 1, ..., f(0), keeping their order. Rebuilds the complex, the undo log is discarded.
+    void relabel();
+    
+    // brings snapshot up to date with the complex. If snapshot was the last one taken from this complex,
+    // only the facets changed since are applied, otherwise all facets are copied.
+    void snapshot(ComplexSnapshot & snapshot);
     
     // serialization methods
     friend std::ostream & operator<< (std::ostream & os, const MovableComplex & complex);
@@ -46,7 +144,6 @@ public:
     
     // helper functions
     friend void updateBallBoundary(MovableComplex & complex, const face_list_t & ballBoundaryFaces);
-    friend void updateMoveValidity(MovableComplex & complex);
 };
 
 #endif
@@ -0,0 +1,126 @@
+//
+//  move_trace.cpp
+//  Bistellar
+//
+
+#include "move_trace.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+static const char traceMagic[4] = {'B', 'S', 'T', 'R'};
+static const unsigned char traceVersion = 1;
+
+MoveTrace::MoveTrace() : _size(0)
+{
+}
+
+size_t MoveTrace::size() const
+{
+    return _size;
+}
+
+void MoveTrace::writeNumber(unsigned long long number)
+{
+    while (number >= 0x80)
+    {
+        _data.push_back(static_cast< unsigned char >(number & 0x7f) | 0x80);
+        number >>= 7;
+    }
+    _data.push_back(static_cast< unsigned char >(number));
+}
+
+void MoveTrace::writeFace(const Face & face)
+{
+    writeNumber(face.dimension()+1);
+    vertex_t previous = 0;
+    for (int i = 0; i < face.dimension()+1; i++)
+    {
+        writeNumber(face.vertex(i) - previous);
+        previous = face.vertex(i);
+    }
+}
+
+void MoveTrace::record(const BistellarMove & move)
+{
+    _positions.push_back(_data.size());
+    writeFace(move.face());
+    writeFace(move.link());
+    _size++;
+}
+
+void MoveTrace::truncate(size_t size)
+{
+    if (size >= _size)
+        return;
+    
+    _data.resize(_positions[size]);
+    _positions.resize(size);
+    _size = size;
+}
+
+bool MoveTrace::write(const std::string & path) const
+{
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file.write(traceMagic, sizeof(traceMagic));
+    file.put(static_cast< char >(traceVersion));
+    if (!_data.empty())
+        file.write(reinterpret_cast< const char * >(&_data[0]), _data.size());
+    
+    return static_cast< bool >(file);
+}
+
+// reads a varint at position, returns false at the end of the data
+static bool readNumber(const std::vector< unsigned char > & data, size_t & position, unsigned long long & number)
+{
+    number = 0;
+    for (unsigned int shift = 0; position < data.size() && shift < 64; shift += 7)
+    {
+        unsigned char byte = data[position++];
+        number |= static_cast< unsigned long long >(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+static bool readFace(const std::vector< unsigned char > & data, size_t & position, std::vector< vertex_t > & vertices, Face & face)
+{
+    unsigned long long numberOfVertices, gap;
+    if (!readNumber(data, position, numberOfVertices) || numberOfVertices > data.size() - position)
+        return false;
+    
+    vertices.resize(numberOfVertices);
+    vertex_t previous = 0;
+    for (unsigned long long i = 0; i < numberOfVertices; i++)
+    {
+        if (!readNumber(data, position, gap))
+            return false;
+        previous += static_cast< vertex_t >(gap);
+        vertices[i] = previous;
+    }
+    
+    face = (numberOfVertices == 0) ? Face() : Face(&vertices[0], static_cast< int >(numberOfVertices) - 1);
+    return true;
+}
+
+bool MoveTrace::read(const std::string & path, bistellar_move_list_t & moves)
+{
+    std::ifstream file(path.c_str(), std::ios::binary);
+    std::vector< unsigned char > data((std::istreambuf_iterator< char >(file)), std::istreambuf_iterator< char >());
+    
+    if (data.size() < sizeof(traceMagic)+1 || !std::equal(traceMagic, traceMagic + sizeof(traceMagic), data.begin()) || data[sizeof(traceMagic)] != traceVersion)
+        return false;
+    
+    std::vector< vertex_t > vertices;
+    size_t position = sizeof(traceMagic)+1;
+    while (position < data.size())
+    {
+        Face face, link;
+        if (!readFace(data, position, vertices, face) || !readFace(data, position, vertices, link))
+            return false;
+        moves.push_back(BistellarMove(face, link));
+    }
+    
+    return true;
+}
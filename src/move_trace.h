@@ -0,0 +1,46 @@
+//
+//  move_trace.h
+//  Bistellar
+//
+
+#ifndef Bistellar_move_trace_h
+#define Bistellar_move_trace_h
+
+#include <string>
+#include <vector>
+#include "types.h"
+#include "bistellar_move.h"
+
+// A compact binary record of applied moves, which can be written to and read from a file.
+// The file starts with the magic "BSTR" and a version byte, followed by the moves. A move is stored as
+// face and link, a face as its number of vertices followed by the first vertex and the gaps between the
+// (sorted) vertices, all as LEB128 varints. So a move mostly takes one byte per vertex.
+// Moves of codimension 0 are recorded as resolved by MovableComplex::resolvedMove, with the vertex they create as
+// link, so a trace replays on any complex with the same facets.
+class MoveTrace
+{
+    std::vector< unsigned char > _data;
+    size_t _size;
+    // byte positions of the moves, only used to truncate the trace
+    std::vector< size_t > _positions;
+    
+    void writeNumber(unsigned long long number);
+    void writeFace(const Face & face);
+    
+public:
+    MoveTrace();
+    
+    // the number of recorded moves
+    size_t size() const;
+    
+    void record(const BistellarMove & move);
+    // drops all moves but the first size ones
+    void truncate(size_t size);
+    
+    // returns false if the file could not be written
+    bool write(const std::string & path) const;
+    // reads the moves of a trace file into moves. Returns false if the file could not be read or is no trace.
+    static bool read(const std::string & path, bistellar_move_list_t & moves);
+};
+
+#endif
@@ -8,13 +8,11 @@
 
 #include "randomize_complex.h"
 
-#include <stdlib.h>
-#include <time.h>
 
-void randomize_complex(MovableComplex & complex, const std::vector< unsigned int > & allowedMoves, unsigned int rounds)
+void randomize_complex(MovableComplex & complex, const std::vector< unsigned int > & allowedMoves, unsigned int rounds, unsigned int seed, MoveTrace * trace)
 {
     // initialize the RNG
-    srand(static_cast<unsigned int>(time(0)));
+    random_engine_t rng(seed);
     
     for (int currentRound = 0; currentRound < rounds; currentRound++)
     {
@@ -29,7 +27,7 @@ void randomize_complex(MovableComplex & complex, const std::vector< unsigned int
             break;
         
         int codimension = 0;
-        for (int i = 0, r = rand() % numberOfCodimensions; i < allowedMoves.size() && r >= 0; i++)
+        for (int i = 0, r = rng() % numberOfCodimensions; i < allowedMoves.size() && r >= 0; i++)
         {
             if (complex.hasValidMoves(allowedMoves[i]))
             {
@@ -38,8 +36,9 @@ void randomize_complex(MovableComplex & complex, const std::vector< unsigned int
             }
         }
         
-        bistellar_move_list_t validMoves = complex.validMoves(codimension);
-        BistellarMove move = validMoves.at(rand() % validMoves.size());
+        BistellarMove move = complex.randomValidMove(codimension, rng);
+        if (trace != 0)
+            trace->record(complex.resolvedMove(move));
         complex.moveComplex(move);
     }
 }
\ No newline at end of file
@@ -10,8 +10,10 @@
 #define Bistellar_randomize_complex_h
 
 #include "movable_complex.h"
+#include "move_trace.h"
 #include <vector>
 
-void randomize_complex(MovableComplex & complex, const std::vector< unsigned int > & allowedMoves, unsigned int rounds);
+// applies rounds random moves of the allowed codimensions, using an RNG seeded with seed. The moves are recorded in trace if given.
+void randomize_complex(MovableComplex & complex, const std::vector< unsigned int > & allowedMoves, unsigned int rounds, unsigned int seed, MoveTrace * trace = 0);
 
 #endif
@@ -0,0 +1,159 @@
+//
+//  recognize_manifold.cpp
+//  Bistellar
+//
+
+#include "recognize_manifold.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include "reduce_complex.h"
+
+// tests if the facets of dimension dimension > 0 form a closed pseudomanifold whose vertices are connected
+static bool isConnectedClosedPseudomanifold(const face_list_t & facets, unsigned int dimension)
+{
+    face_count_map_t ridges;
+    for (face_list_t::const_iterator it = facets.begin(); it != facets.end(); it++)
+    {
+        for (unsigned int i = 0; i < dimension+1; i++)
+            ridges[it->boundaryFace(i)]++;
+    }
+    for (face_count_map_t::const_iterator it = ridges.begin(); it != ridges.end(); it++)
+    {
+        if (it->second != 2)
+            return false;
+    }
+
+    // union-find on the vertices, every facet joins its vertices
+    std::unordered_map< vertex_t, vertex_t > parent;
+    for (face_list_t::const_iterator it = facets.begin(); it != facets.end(); it++)
+    {
+        for (unsigned int i = 0; i < dimension+1; i++)
+            parent.emplace(it->vertex(i), it->vertex(i));
+    }
+    auto root = [&parent](vertex_t v)
+    {
+        while (parent[v] != v)
+        {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+    unsigned int components = static_cast< unsigned int >(parent.size());
+    for (face_list_t::const_iterator it = facets.begin(); it != facets.end(); it++)
+    {
+        for (unsigned int i = 1; i < dimension+1; i++)
+        {
+            vertex_t root1 = root(it->vertex(0));
+            vertex_t root2 = root(it->vertex(i));
+            if (root1 != root2)
+            {
+                parent[root1] = root2;
+                components--;
+            }
+        }
+    }
+
+    return components == 1;
+}
+
+// reduces the link of a vertex until it is the boundary of a simplex, i.e. has dimension+2 vertices
+static link_verdict_t checkLink(const face_list_t & facets, unsigned int dimension, unsigned int rounds, const ReductionSchedule & schedule, random_engine_t & rng, const std::atomic< bool > & stop)
+{
+    // the only 0-sphere consists of two points
+    if (dimension == 0)
+        return facets.size() == 2 ? link_sphere : link_not_sphere;
+
+    if (!isConnectedClosedPseudomanifold(facets, dimension))
+        return link_not_sphere;
+
+    MovableComplex link(facets, dimension);
+    int heating = 0;
+    int relaxation = 4;
+    for (unsigned int currentRound = 0; currentRound < rounds && link.f(0) > dimension+2; currentRound++)
+    {
+        if (stop)
+            return link_unchecked;
+
+        codimension_list_t moves;
+        schedule.selectCodimensions(link, heating, relaxation, moves);
+        if (numberOfValidMoves(link, moves) == 0)
+            break;
+
+        link.moveComplex(randomValidMove(link, moves, rng));
+    }
+
+    // a closed pseudomanifold of dimension d on d+2 vertices is the boundary of the (d+1)-simplex
+    return link.f(0) == dimension+2 ? link_sphere : link_unknown;
+}
+
+manifold_verdict_t recognize_manifold(const MovableComplex & complex, unsigned int rounds, const ReductionSchedule & schedule, unsigned int threads, unsigned int seed, link_verdict_list_t & verdicts)
+{
+    verdicts.clear();
+
+    // the only closed 0-manifold which is a sphere is S^0, as in SCBistellarIsManifold
+    if (complex.dimension() == 0)
+        return complex.f(0) == 2 ? manifold_true : manifold_false;
+
+    // the link of a vertex consists of the facets containing it with the vertex removed
+    const face_set_t & facets = complex.faces(complex.dimension());
+    std::unordered_map< vertex_t, face_list_t > links;
+    for (face_set_t::const_iterator it = facets.begin(); it != facets.end(); it++)
+    {
+        for (int i = 0; i < it->dimension()+1; i++)
+            links[it->vertex(i)].push_back(it->boundaryFace(i));
+    }
+
+    std::vector< vertex_t > vertices;
+    for (std::unordered_map< vertex_t, face_list_t >::const_iterator it = links.begin(); it != links.end(); it++)
+        vertices.push_back(it->first);
+    std::sort(vertices.begin(), vertices.end());
+
+    std::vector< link_verdict_t > results(vertices.size(), link_unchecked);
+    // workers take the next unchecked vertex until all are taken or one link is no recognized sphere
+    std::atomic< size_t > nextVertex(0);
+    std::atomic< bool > stop(false);
+    unsigned int linkDimension = complex.dimension()-1;
+
+    auto work = [&]()
+    {
+        for (size_t i = nextVertex++; i < vertices.size() && !stop; i = nextVertex++)
+        {
+            // every link gets its own RNG stream, so its verdict does not depend on the worker checking it
+            std::seed_seq seeds = {seed, vertices[i]};
+            random_engine_t rng(seeds);
+            results[i] = checkLink(links.find(vertices[i])->second, linkDimension, rounds, schedule, rng, stop);
+            if (results[i] != link_sphere && results[i] != link_unchecked)
+                stop = true;
+        }
+    };
+
+    threads = std::max(1u, std::min(threads, static_cast< unsigned int >(vertices.size())));
+    if (threads == 1)
+    {
+        work();
+    }
+    else
+    {
+        std::vector< std::thread > workers;
+        for (unsigned int i = 0; i < threads; i++)
+            workers.push_back(std::thread(work));
+        for (unsigned int i = 0; i < threads; i++)
+            workers[i].join();
+    }
+
+    manifold_verdict_t verdict = manifold_true;
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        verdicts.push_back(std::make_pair(vertices[i], results[i]));
+        if (results[i] == link_not_sphere)
+            verdict = manifold_false;
+        else if (results[i] != link_sphere && verdict == manifold_true)
+            verdict = manifold_unknown;
+    }
+
+    return verdict;
+}
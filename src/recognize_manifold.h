@@ -0,0 +1,44 @@
+//
+//  recognize_manifold.h
+//  Bistellar
+//
+
+#ifndef Bistellar_recognize_manifold_h
+#define Bistellar_recognize_manifold_h
+
+#include <utility>
+#include <vector>
+#include "movable_complex.h"
+#include "reduction_schedule.h"
+
+// result of the test of a single vertex link
+enum link_verdict_t
+{
+    // the link was not examined because the test stopped early
+    link_unchecked,
+    // the link was reduced to the boundary of a simplex, so it is a PL sphere
+    link_sphere,
+    // the link could not be reduced to the boundary of a simplex within the given number of rounds
+    link_unknown,
+    // the link is no connected closed pseudomanifold (or, for links of dimension 0, has not exactly two vertices)
+    link_not_sphere
+};
+
+// result of a manifold recognition. Like sphere recognition in general, it may end without an answer.
+enum manifold_verdict_t
+{
+    manifold_unknown,
+    manifold_true,
+    manifold_false
+};
+
+typedef std::vector< std::pair< vertex_t, link_verdict_t > > link_verdict_list_t;
+
+// tests if complex is a closed combinatorial manifold, i.e. if the links of all vertices are PL spheres. Every link
+// is checked to be a connected closed pseudomanifold and then reduced as by reduce_complex with the given schedule
+// until it is the boundary of a simplex or rounds moves were applied. The links are distributed to threads workers,
+// which stop as soon as one link is not recognized as a sphere. verdicts receives the verdict of every vertex in
+// increasing order. Returns manifold_false if a link is no sphere and manifold_unknown if a link could not be reduced.
+manifold_verdict_t recognize_manifold(const MovableComplex & complex, unsigned int rounds, const ReductionSchedule & schedule, unsigned int threads, unsigned int seed, link_verdict_list_t & verdicts);
+
+#endif
@@ -9,263 +9,226 @@
 
 #include "reduce_complex.h"
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include <stdlib.h>
-#include <time.h>
-
-const unsigned int baseHeating = 4;
-const unsigned int baseRelaxation = 3;
 
+unsigned int numberOfValidMoves(const MovableComplex & complex, const codimension_list_t & codimensions)
+{
+    unsigned int numberOfMoves = 0;
+    for (codimension_list_t::const_iterator it = codimensions.begin(); it != codimensions.end(); it++)
+        numberOfMoves += complex.numberOfValidMoves(*it);
+    
+    return numberOfMoves;
+}
 
-void reduce_complex(MovableComplex & complex, unsigned int rounds, int heating, int relaxation)
+BistellarMove randomValidMove(const MovableComplex & complex, const codimension_list_t & codimensions, random_engine_t & rng)
 {
-    if (complex.dimension() == 0)
-        return;
+    unsigned int i = rng() % numberOfValidMoves(complex, codimensions);
+    for (codimension_list_t::const_iterator it = codimensions.begin(); it != codimensions.end(); it++)
+    {
+        if (i < complex.numberOfValidMoves(*it))
+            return complex.validMove(*it, i);
+        i -= complex.numberOfValidMoves(*it);
+    }
     
-    // initialize the RNG
-    srand(static_cast<unsigned int>(time(0)));
+    return BistellarMove();
+}
+
+
+// a chain draws at most this many moves per round to find one not leading into a tabu state
+const unsigned int maximalTabuAttempts = 8;
+
+// the hashes of the states a chain visited last
+class TabuList
+{
+    size_t _capacity;
+    std::deque< unsigned long long > _recent;
+    std::unordered_map< unsigned long long, unsigned int > _counts;
 
-    MovableComplex minimalComplex = complex;
+public:
+    TabuList(size_t capacity) : _capacity(capacity) {}
+
+    bool contains(unsigned long long hash) const
+    {
+        return _counts.count(hash) != 0;
+    }
+
+    // adds hash and forgets the oldest state if there are more than capacity
+    void insert(unsigned long long hash)
+    {
+        if (_capacity == 0)
+            return;
+        
+        _recent.push_back(hash);
+        _counts[hash]++;
+        if (_recent.size() > _capacity)
+        {
+            std::unordered_map< unsigned long long, unsigned int >::iterator it = _counts.find(_recent.front());
+            if (--it->second == 0)
+                _counts.erase(it);
+            _recent.pop_front();
+        }
+    }
+};
+
+// the progress shared by the chains of a reduction
+struct ReductionProgress
+{
+    // the least number of vertices found by any chain
+    std::atomic< unsigned int > minimalVertices;
+    // chains whose best complex has more than minimalVertices + abandonDistance vertices stop, 0 never stops them
+    unsigned int abandonDistance;
+    // the number of states a chain remembers as tabu, 0 disables the tabu list
+    unsigned int tabuSize;
+    // moves drawn but skipped because they led into a tabu state, and rounds in which all moves drawn did
+    std::atomic< unsigned long long > tabuRejections;
+    std::atomic< unsigned long long > tabuForcedMoves;
+    // guards improvements of minimalVertices and the output
+    std::mutex mutex;
+};
+
+// reduces complex by one random descent chain and leaves it at the best complex found. If trace is given, it receives the moves leading there.
+void reduce_chain(MovableComplex & complex, unsigned int rounds, const ReductionSchedule & schedule, int heating, int relaxation, random_engine_t & rng, ReductionProgress & progress, MoveTrace * trace)
+{
+    // the best complex found so far. Updating the snapshot only costs the facets changed since the last improvement.
+    ComplexSnapshot minimalComplex;
+    complex.snapshot(minimalComplex);
+    unsigned int minimalVertices = complex.f(0);
+    // as long as fewer moves than facets were applied since the last improvement, the best complex is restored by rolling them back
+    size_t minimalCheckpoint = complex.checkpoint();
+    bool canRollback = true;
+    size_t minimalTraceSize = trace != 0 ? trace->size() : 0;
+    TabuList tabu(progress.tabuSize);
+    tabu.insert(complex.hash());
     
     for (int currentRound = 1; currentRound < rounds; currentRound++)
     {
-        // select move
-        bistellar_move_list_t moves;
+        // select the codimensions to choose the move from
+        codimension_list_t moves;
+        schedule.selectCodimensions(complex, heating, relaxation, moves);
         
-        if (complex.dimension() < 3)
+        // perform move
+        if (numberOfValidMoves(complex, moves) == 0)
+            break;
+
+        BistellarMove move = randomValidMove(complex, moves, rng);
+        if (progress.tabuSize > 0)
         {
-            unsigned int i = complex.dimension();
-            while (moves.empty())
+            // redraw moves leading back into a recently visited state. If all do, the last one is applied anyway.
+            unsigned int attempts = std::min(maximalTabuAttempts, numberOfValidMoves(complex, moves));
+            for (unsigned int i = 1; i < attempts && tabu.contains(complex.hashAfter(move)); i++)
             {
-                moves = complex.validMoves(i);
-                i--;
+                progress.tabuRejections++;
+                move = randomValidMove(complex, moves, rng);
             }
+            if (tabu.contains(complex.hashAfter(move)))
+                progress.tabuForcedMoves++;
         }
-        else if (complex.dimension() == 3)
+        if (trace != 0)
+            trace->record(complex.resolvedMove(move));
+        complex.moveComplex(move);
+        tabu.insert(complex.hash());
+        
+        if (complex.f(0) < minimalVertices)
         {
-            if (heating > 0)
-            {
-                if (heating % 15 == 0)
-                {
-                    moves = complex.validMoves(0);
-                }
-                else
-                {
-                    moves = complex.validMoves(1);
-                    if (moves.empty())
-                    {
-                        moves = complex.validMoves(2);
-                        heating = 0;
-                    }
-                }
-                heating--;
-            }
-            else
+            complex.snapshot(minimalComplex);
+            minimalVertices = complex.f(0);
+            minimalTraceSize = trace != 0 ? trace->size() : 0;
+            
+            // only improvements over all chains are reported
             {
-                moves = complex.validMoves(3);
-                if (moves.empty())
+                std::lock_guard< std::mutex > lock(progress.mutex);
+                if (minimalVertices < progress.minimalVertices)
                 {
-                    moves = complex.validMoves(2);
-                    if (moves.empty())
-                    {
-                        moves = complex.validMoves(1);
-                        if (relaxation == 10)
-                        {
-                            heating = 15;
-                            relaxation = 0;
-                        }
-                        relaxation++;
-                    }
+                    progress.minimalVertices = minimalVertices;
+                    std::cout << "found complex with " << minimalVertices << " vertices in round " << currentRound << std::endl;
                 }
             }
+            
+            complex.commit();
+            minimalCheckpoint = complex.checkpoint();
+            canRollback = true;
         }
-        else if (complex.dimension() == 4)
+        else if (canRollback && complex.numberOfLoggedMoves() > complex.f(complex.dimension()))
         {
-            if (heating > 0)
-            {
-                if (heating % 20 == 0)
-                {
-                    moves = complex.validMoves(0);
-                }
-                else
-                {
-                    moves = complex.validMoves(1);
-                    bistellar_move_list_t temp = complex.validMoves(2);
-                    if (!temp.empty())
-                        moves.insert(moves.begin(), temp.begin(), temp.end());
-                    
-                    if (moves.empty())
-                        moves = complex.validMoves(3);
-                }
-                heating--;
-            }
-            else
-            {
-                moves = complex.validMoves(4);
-                if (moves.empty())
-                {
-                    moves = complex.validMoves(3);
-                    if (moves.empty())
-                    {
-                        moves = complex.validMoves(2);
-                        bistellar_move_list_t temp = complex.validMoves(1);
-                        if (!temp.empty())
-                            moves.insert(moves.begin(), temp.begin(), temp.end());
-
-                        if (relaxation == 10)
-                        {
-                            heating = 20;
-                            relaxation = 0;
-                        }
-                        relaxation++;
-                    }
-                }
-            }
+            // rebuilding from the snapshot is cheaper than undoing that many moves
+            complex.commit();
+            canRollback = false;
         }
-        else if (complex.dimension() == 5)
-        {
-            if (heating > 0)
-            {
-                if (heating % 40 == 0)
-                {
-                    moves = complex.validMoves(0);
-                }
-                else
-                {
-                    moves = complex.validMoves(1);
-                    bistellar_move_list_t temp = complex.validMoves(2);
-                    if (!temp.empty())
-                        moves.insert(moves.begin(), temp.begin(), temp.end());
-                    temp = complex.validMoves(3);
-                    if (!temp.empty())
-                        moves.insert(moves.begin(), temp.begin(), temp.end());
-                    
-                    if (moves.empty())
-                        moves = complex.validMoves(4);
-                }
-                heating--;
-            }
-            else
-            {
-                moves = complex.validMoves(5);
-                if (moves.empty())
-                {
-                    moves = complex.validMoves(4);
-                    if (moves.empty())
-                    {
-                        moves = complex.validMoves(3);
-                        if (moves.empty())
-                        {
-                            moves = complex.validMoves(2);
-                            bistellar_move_list_t temp = complex.validMoves(1);
-                            if (!temp.empty())
-                                moves.insert(moves.begin(), temp.begin(), temp.end());
+        
+        if (progress.abandonDistance > 0 && minimalVertices > progress.minimalVertices + progress.abandonDistance)
+            break;
+    }
+    
+    if (canRollback)
+    {
+        complex.rollback(minimalCheckpoint);
+        complex.commit();
+    }
+    else
+    {
+        complex = MovableComplex(minimalComplex);
+    }
+    
+    if (trace != 0)
+        trace->truncate(minimalTraceSize);
+}
 
-                            if (relaxation == 20)
-                            {
-                                heating = 40;
-                                relaxation = 0;
-                            }
-                            relaxation++;
-                        }
-                    }
-                }
-            }
-            
-        }
-        else
+void reduce_complex(MovableComplex & complex, unsigned int rounds, const ReductionSchedule & schedule, int heating, int relaxation, unsigned int threads, unsigned int abandonDistance, unsigned int tabuSize, unsigned int seed, MoveTrace * trace)
+{
+    if (complex.dimension() == 0)
+        return;
+    
+    ReductionProgress progress;
+    progress.minimalVertices = complex.f(0);
+    progress.abandonDistance = abandonDistance;
+    progress.tabuSize = tabuSize;
+    progress.tabuRejections = 0;
+    progress.tabuForcedMoves = 0;
+    
+    // every chain gets its own RNG stream
+    if (threads <= 1)
+    {
+        std::seed_seq seeds = {seed, 0u};
+        random_engine_t rng(seeds);
+        reduce_chain(complex, rounds, schedule, heating, relaxation, rng, progress, trace);
+    }
+    else
+    {
+        // each chain works on its own copy, which allocates from its own memory
+        std::vector< MovableComplex > chains(threads, complex);
+        std::vector< MoveTrace > traces(trace != 0 ? threads : 0);
+        std::vector< std::thread > workers;
+        for (unsigned int i = 0; i < threads; i++)
         {
-            if (heating > 0)
+            workers.push_back(std::thread([&chains, &traces, &progress, &schedule, i, seed, rounds, heating, relaxation]()
             {
-                //if (heating % ((complex.dimension()+2)*baseHeating) == 0)
-                //{
-                //    moves = complex.validMoves(0);
-                //}
-                //else
-                //{
-                    for (unsigned int i = 1; i < complex.dimension()/2 + 1; i++)
-                    {
-                        bistellar_move_list_t temp = complex.validMoves(i);
-                        if (!temp.empty())
-                            moves.insert(moves.begin(), temp.begin(), temp.end());
-                    }
-                //}
-                if (moves.empty())
-                {
-                    for (unsigned int i = 1; i < complex.dimension()+2; i++)
-                    {
-                        bistellar_move_list_t temp = complex.validMoves(complex.dimension() + 1 - i);
-                        if (!temp.empty())
-                        {
-                            moves.insert(moves.begin(), temp.begin(), temp.end());
-                            if (i > (complex.dimension()-1)/2)
-                                break;
-                        }
-                    }
-                }
-                heating--;
-            }
-            else
-            {
-                if (complex.dimension() % 2 == 1)
-                {
-                    for (unsigned int i = 1; i < (complex.dimension()+1)/2 + 1; i++)
-                    {
-                        bistellar_move_list_t temp = complex.validMoves(complex.dimension() + 1 - i);
-                        if (!temp.empty())
-                        {
-                            moves = temp;
-                            break;
-                        }
-                    }
-                }
-                else
-                {
-                    for (unsigned int i = 1; i < std::min((complex.dimension()+1)/2 + 1, complex.dimension())+1; i++)
-                    {
-                        bistellar_move_list_t temp = complex.validMoves(complex.dimension() + 1 - i);
-                        if (!temp.empty())
-                        {
-                            moves = temp;
-                            break;
-                        }
-                    }
-                }
-                if (moves.empty())
-                {
-                    for (unsigned int i = 1; i < std::min((complex.dimension()+1)/2 + 1, complex.dimension())+1; i++)
-                    {
-                        bistellar_move_list_t temp = complex.validMoves(i);
-                        if (!temp.empty())
-                        {
-                            moves = temp;
-                            break;
-                        }
-                    }
-                }
-                if (relaxation == (complex.dimension()+2)*baseRelaxation)
-                {
-                    //heating = (complex.dimension()+2)*baseHeating;
-		    heating = 1;
-                    relaxation = 0;
-                }
-                relaxation++;
-            }
+                std::seed_seq seeds = {seed, i};
+                random_engine_t rng(seeds);
+                reduce_chain(chains[i], rounds, schedule, heating, relaxation, rng, progress, traces.empty() ? 0 : &traces[i]);
+            }));
         }
-            
-        // perform move
-        if (moves.size() == 0)
-            break;
-
-        BistellarMove move = moves.at(rand() % moves.size());
-        complex.moveComplex(move);
         
-        if (complex.f(0) < minimalComplex.f(0))
+        unsigned int best = 0;
+        for (unsigned int i = 0; i < threads; i++)
         {
-            minimalComplex = complex;
-            std::cout << "found complex with " << minimalComplex.f(0) << " vertices in round " << currentRound << std::endl;
-            
+            workers[i].join();
+            if (chains[i].f(0) < chains[best].f(0))
+                best = i;
         }
+        
+        complex = std::move(chains[best]);
+        if (trace != 0)
+            *trace = traces[best];
     }
-    complex = minimalComplex;
+    
+    if (tabuSize > 0)
+        std::cout << "tabu rejected " << progress.tabuRejections << " moves into recently visited states, " << progress.tabuForcedMoves << " moves were forced" << std::endl;
 }
@@ -10,7 +10,19 @@
 #define Bistellar_reduce_complex_h
 
 #include "movable_complex.h"
+#include "move_trace.h"
+#include "reduction_schedule.h"
 
-void reduce_complex(MovableComplex & complex, unsigned int rounds, int heating, int relaxation);
+// returns the number of valid moves of all given codimensions
+unsigned int numberOfValidMoves(const MovableComplex & complex, const codimension_list_t & codimensions);
+// returns a move chosen uniformly at random among the valid moves of all given codimensions, which must have valid moves
+BistellarMove randomValidMove(const MovableComplex & complex, const codimension_list_t & codimensions, random_engine_t & rng);
+
+// reduces complex by threads independent random descent chains and sets it to the best complex found by any of them.
+// The chains select their moves by schedule, starting from the given heating and relaxation.
+// If abandonDistance > 0, chains whose best complex has more than abandonDistance vertices more than the overall best stop early.
+// If tabuSize > 0, every chain remembers the hashes of the last tabuSize states it visited and redraws moves leading back into them.
+// The RNG streams of the chains are derived from seed. If trace is given, it receives the moves leading to the result.
+void reduce_complex(MovableComplex & complex, unsigned int rounds, const ReductionSchedule & schedule, int heating, int relaxation, unsigned int threads, unsigned int abandonDistance, unsigned int tabuSize, unsigned int seed, MoveTrace * trace = 0);
 
 #endif
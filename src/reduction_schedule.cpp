@@ -0,0 +1,180 @@
+//
+//  reduction_schedule.cpp
+//  Bistellar
+//
+
+#include "reduction_schedule.h"
+
+#include <algorithm>
+#include "reduce_complex.h"
+
+// returns the index of the first codimensions with valid moves, or the last index if there are none
+static size_t firstMovable(const MovableComplex & complex, const std::vector< codimension_list_t > & moves)
+{
+    for (size_t i = 0; i + 1 < moves.size(); i++)
+    {
+        if (numberOfValidMoves(complex, moves[i]) > 0)
+            return i;
+    }
+
+    return moves.size() - 1;
+}
+
+TableSchedule::TableSchedule(const std::vector< ScheduleEntry > & entries, unsigned int baseHeating, unsigned int baseRelaxation) : _entries(entries), _baseHeating(baseHeating), _baseRelaxation(baseRelaxation)
+{
+}
+
+void TableSchedule::selectCodimensions(const MovableComplex & complex, int & heating, int & relaxation, codimension_list_t & codimensions) const
+{
+    codimensions.clear();
+
+    if (complex.dimension() < _entries.size())
+    {
+        const ScheduleEntry & entry = _entries[complex.dimension()];
+
+        if (heating > 0 && !entry.heatingMoves.empty())
+        {
+            if (entry.heatingPeriod > 0 && heating % entry.heatingPeriod == 0)
+            {
+                codimensions.assign(1, 0);
+            }
+            else
+            {
+                size_t i = firstMovable(complex, entry.heatingMoves);
+                codimensions = entry.heatingMoves[i];
+                if (i > 0 && entry.stopHeating)
+                    heating = 0;
+            }
+            heating--;
+        }
+        else
+        {
+            size_t i = firstMovable(complex, entry.coolingMoves);
+            codimensions = entry.coolingMoves[i];
+            if (i + 1 == entry.coolingMoves.size() && entry.relaxationLength > 0)
+            {
+                if (relaxation == static_cast< int >(entry.relaxationLength))
+                {
+                    heating = entry.heatingLength;
+                    relaxation = 0;
+                }
+                relaxation++;
+            }
+        }
+
+        return;
+    }
+
+    unsigned int dimension = complex.dimension();
+    unsigned int heatingLength = (dimension+2)*_baseHeating;
+
+    if (heating > 0)
+    {
+        if (heatingLength > 0 && heating % heatingLength == 0)
+        {
+            codimensions.assign(1, 0);
+        }
+        else
+        {
+            for (unsigned int i = 1; i < dimension/2 + 1; i++)
+                codimensions.push_back(i);
+        }
+        if (numberOfValidMoves(complex, codimensions) == 0)
+        {
+            for (unsigned int i = 1; i < dimension+2; i++)
+            {
+                if (complex.hasValidMoves(dimension + 1 - i))
+                {
+                    codimensions.push_back(dimension + 1 - i);
+                    if (i > (dimension-1)/2)
+                        break;
+                }
+            }
+        }
+        heating--;
+    }
+    else
+    {
+        // odd dimensions try the codimensions down to (d+1)/2, even ones down to d/2
+        unsigned int lowest = (dimension % 2 == 1) ? (dimension+1)/2 : std::min((dimension+1)/2 + 1, dimension);
+        for (unsigned int i = 1; i < lowest+1; i++)
+        {
+            if (complex.hasValidMoves(dimension + 1 - i))
+            {
+                codimensions.assign(1, dimension + 1 - i);
+                break;
+            }
+        }
+        if (numberOfValidMoves(complex, codimensions) == 0)
+        {
+            for (unsigned int i = 1; i < std::min((dimension+1)/2 + 1, dimension)+1; i++)
+            {
+                if (complex.hasValidMoves(i))
+                {
+                    codimensions.assign(1, i);
+                    break;
+                }
+            }
+        }
+        if (relaxation == static_cast< int >((dimension+2)*_baseRelaxation))
+        {
+            heating = heatingLength > 0 ? heatingLength : 1;
+            relaxation = 0;
+        }
+        relaxation++;
+    }
+}
+
+void DescentSchedule::selectCodimensions(const MovableComplex & complex, int &, int &, codimension_list_t & codimensions) const
+{
+    codimensions.assign(1, 1);
+    for (unsigned int i = complex.dimension(); i > 1; i--)
+    {
+        if (complex.hasValidMoves(i))
+        {
+            codimensions.assign(1, i);
+            break;
+        }
+    }
+}
+
+// the established schedule for dimensions up to 5
+static std::vector< ScheduleEntry > defaultEntries()
+{
+    std::vector< ScheduleEntry > entries(6);
+
+    // dimensions 0 to 2 never heat and apply the moves of the highest codimension available
+    for (unsigned int dimension = 0; dimension < 3; dimension++)
+    {
+        entries[dimension].heatingPeriod = 0;
+        entries[dimension].stopHeating = false;
+        for (unsigned int i = 0; i < dimension+1; i++)
+            entries[dimension].coolingMoves.push_back(codimension_list_t(1, dimension - i));
+        entries[dimension].relaxationLength = 0;
+        entries[dimension].heatingLength = 0;
+    }
+
+    entries[3] = {15, {{1}, {2}}, true, {{3}, {2}, {1}}, 10, 15};
+    entries[4] = {20, {{1, 2}, {3}}, false, {{4}, {3}, {2, 1}}, 10, 20};
+    entries[5] = {40, {{1, 2, 3}, {4}}, false, {{5}, {4}, {3}, {2, 1}}, 20, 40};
+
+    return entries;
+}
+
+const ReductionSchedule * reduction_schedule(const std::string & name)
+{
+    // the default schedule heats higher dimensions for a single round only
+    static const TableSchedule defaultSchedule(defaultEntries(), 0, 3);
+    // the heating periods of SCIntFunc.SCChooseMove for higher dimensions
+    static const TableSchedule scaledSchedule(defaultEntries(), 4, 3);
+    static const DescentSchedule descentSchedule;
+
+    if (name.compare("default") == 0)
+        return &defaultSchedule;
+    else if (name.compare("scaled") == 0)
+        return &scaledSchedule;
+    else if (name.compare("descent") == 0)
+        return &descentSchedule;
+
+    return 0;
+}
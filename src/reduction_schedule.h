@@ -0,0 +1,71 @@
+//
+//  reduction_schedule.h
+//  Bistellar
+//
+
+#ifndef Bistellar_reduction_schedule_h
+#define Bistellar_reduction_schedule_h
+
+#include <string>
+#include <vector>
+#include "types.h"
+#include "movable_complex.h"
+
+// A schedule decides from which codimensions a reduction chain draws its next move, the move itself is chosen
+// uniformly among the valid moves of these codimensions. Its state are two counters of the chain: heating > 0
+// is the number of remaining rounds in which the chain applies moves enlarging the complex, relaxation counts
+// the rounds in which the chain got stuck while reducing.
+class ReductionSchedule
+{
+public:
+    virtual ~ReductionSchedule() {}
+
+    // sets codimensions to those of the next move of complex and advances heating and relaxation
+    virtual void selectCodimensions(const MovableComplex & complex, int & heating, int & relaxation, codimension_list_t & codimensions) const = 0;
+};
+
+// the behavior of a TableSchedule for one dimension
+struct ScheduleEntry
+{
+    // while heating, every heatingPeriod-th round subdivides a facet, 0 never does
+    unsigned int heatingPeriod;
+    // the codimensions tried in order while heating, the first with valid moves is used, else the last.
+    // Without heating moves the chain never heats.
+    std::vector< codimension_list_t > heatingMoves;
+    // whether heating stops once the first heating codimensions have no valid moves
+    bool stopHeating;
+    // the codimensions tried in order while cooling. The chain is stuck once it falls back to the last.
+    std::vector< codimension_list_t > coolingMoves;
+    // the chain heats for heatingLength rounds after being stuck relaxationLength times, 0 never heats
+    unsigned int relaxationLength;
+    unsigned int heatingLength;
+};
+
+// schedule given by one entry per dimension. Dimensions beyond the table try the higher codimensions
+// first and heat for (d+2)*baseHeating rounds after (d+2)*baseRelaxation rounds, or for a single
+// round without subdivisions if baseHeating is 0.
+class TableSchedule : public ReductionSchedule
+{
+    std::vector< ScheduleEntry > _entries;
+    unsigned int _baseHeating;
+    unsigned int _baseRelaxation;
+
+public:
+    TableSchedule(const std::vector< ScheduleEntry > & entries, unsigned int baseHeating, unsigned int baseRelaxation);
+
+    void selectCodimensions(const MovableComplex & complex, int & heating, int & relaxation, codimension_list_t & codimensions) const;
+};
+
+// schedule which always applies a move of the highest codimension available and never heats
+class DescentSchedule : public ReductionSchedule
+{
+public:
+    void selectCodimensions(const MovableComplex & complex, int & heating, int & relaxation, codimension_list_t & codimensions) const;
+};
+
+// returns the schedule of the given name or 0 if there is none. The schedules are
+// "default", the established table for dimensions up to 5, "scaled", which also heats
+// properly in higher dimensions, and "descent".
+const ReductionSchedule * reduction_schedule(const std::string & name);
+
+#endif
@@ -0,0 +1,168 @@
+//
+//  temper_complex.cpp
+//  Bistellar
+//
+
+#include "temper_complex.h"
+#include "reduce_complex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+TemperingOptions::TemperingOptions() : rounds(10000), replicas(4), minTemperature(0), maxTemperature(0), exchangeInterval(100), threads(std::thread::hardware_concurrency()), seed(0), target(0)
+{
+}
+
+// a replica at one temperature. The temperature and the RNG stay with the replica, the complex changes on exchanges.
+struct Replica
+{
+    MovableComplex complex;
+    double temperature;
+    random_engine_t rng;
+    // the best complex this replica has found, if it was the best of all replicas at that time
+    ComplexSnapshot minimalComplex;
+    unsigned int minimalVertices;
+};
+
+// the progress shared by the replicas
+struct TemperingProgress
+{
+    std::atomic< unsigned int > minimalVertices;
+    unsigned int target;
+    std::atomic< bool > done;
+    // guards improvements of minimalVertices and the output
+    std::mutex mutex;
+};
+
+// proposes rounds moves to the replica and accepts them by the Metropolis criterion
+static void runReplica(Replica & replica, unsigned int firstRound, unsigned int rounds, TemperingProgress & progress)
+{
+    std::uniform_real_distribution< double > uniform(0.0, 1.0);
+    
+    for (unsigned int currentRound = firstRound; currentRound < firstRound + rounds && !progress.done; currentRound++)
+    {
+        // the codimension is chosen first, so the subdivisions, which are as many as the facets, do not swamp the other moves
+        codimension_list_t movableCodimensions;
+        for (unsigned int i = 0; i < replica.complex.dimension()+1; i++)
+        {
+            if (replica.complex.hasValidMoves(i))
+                movableCodimensions.push_back(i);
+        }
+        if (movableCodimensions.empty())
+            break;
+        codimension_list_t codimension(1, movableCodimensions[replica.rng() % movableCodimensions.size()]);
+        BistellarMove move = randomValidMove(replica.complex, codimension, replica.rng);
+        
+        // the energy is the number of facets: a move of codimension k replaces k+1 facets by d-k+1 facets
+        int energyChange = static_cast< int >(replica.complex.dimension()) - 2 * static_cast< int >(move.codimension());
+        
+        if (energyChange > 0 && uniform(replica.rng) >= std::exp(-energyChange / replica.temperature))
+            continue;
+        
+        replica.complex.moveComplex(move);
+        
+        if (move.codimension() == replica.complex.dimension() && replica.complex.f(0) < progress.minimalVertices)
+        {
+            std::lock_guard< std::mutex > lock(progress.mutex);
+            if (replica.complex.f(0) < progress.minimalVertices)
+            {
+                progress.minimalVertices = replica.complex.f(0);
+                replica.minimalVertices = replica.complex.f(0);
+                replica.complex.snapshot(replica.minimalComplex);
+                std::cout << "found complex with " << replica.minimalVertices << " vertices in round " << currentRound << std::endl;
+                
+                if (replica.minimalVertices <= progress.target)
+                    progress.done = true;
+            }
+        }
+    }
+}
+
+void temper_complex(MovableComplex & complex, const TemperingOptions & options)
+{
+    if (complex.dimension() == 0 || options.replicas == 0)
+        return;
+    
+    TemperingProgress progress;
+    progress.minimalVertices = complex.f(0);
+    progress.target = options.target;
+    progress.done = false;
+    
+    // a move of codimension k changes the energy by d-2k, so the temperatures scale with the dimension
+    double minTemperature = (options.minTemperature > 0) ? options.minTemperature : 0.5 * complex.dimension();
+    double maxTemperature = (options.maxTemperature > 0) ? options.maxTemperature : 2.0 * complex.dimension();
+    
+    std::vector< Replica > replicas(options.replicas);
+    for (unsigned int i = 0; i < options.replicas; i++)
+    {
+        replicas[i].complex = complex;
+        replicas[i].temperature = minTemperature;
+        if (options.replicas > 1)
+            replicas[i].temperature *= std::pow(maxTemperature / minTemperature, static_cast< double >(i) / (options.replicas - 1));
+        std::seed_seq seeds = {options.seed, i};
+        replicas[i].rng.seed(seeds);
+        replicas[i].minimalVertices = complex.f(0);
+    }
+    
+    std::seed_seq seeds = {options.seed, options.replicas};
+    random_engine_t rng(seeds);
+    std::uniform_real_distribution< double > uniform(0.0, 1.0);
+    
+    unsigned int threads = std::max(1u, std::min(options.threads, options.replicas));
+    unsigned int exchangeInterval = std::max(1u, options.exchangeInterval);
+    unsigned int attemptedExchanges = 0;
+    unsigned int acceptedExchanges = 0;
+    
+    for (unsigned int firstRound = 1, phase = 0; firstRound < options.rounds && !progress.done; firstRound += exchangeInterval, phase++)
+    {
+        unsigned int rounds = std::min(exchangeInterval, options.rounds - firstRound);
+        
+        // thread t runs the replicas t, t+threads, ...
+        std::vector< std::thread > workers;
+        for (unsigned int t = 1; t < threads; t++)
+        {
+            workers.push_back(std::thread([&replicas, &progress, t, threads, firstRound, rounds]()
+            {
+                for (unsigned int i = t; i < replicas.size(); i += threads)
+                    runReplica(replicas[i], firstRound, rounds, progress);
+            }));
+        }
+        for (unsigned int i = 0; i < replicas.size(); i += threads)
+            runReplica(replicas[i], firstRound, rounds, progress);
+        for (unsigned int t = 0; t < workers.size(); t++)
+            workers[t].join();
+        
+        // exchange the complexes of neighboring replicas, alternating between even and odd pairs. The energy is the
+        // number of facets, as in the chains, so the exchanges keep every replica at its equilibrium distribution.
+        for (unsigned int i = phase % 2; i+1 < replicas.size(); i += 2)
+        {
+            unsigned int d = complex.dimension();
+            double energyDifference = static_cast< double >(replicas[i].complex.f(d)) - replicas[i+1].complex.f(d);
+            double exponent = (1.0 / replicas[i].temperature - 1.0 / replicas[i+1].temperature) * energyDifference;
+            
+            attemptedExchanges++;
+            if (exponent >= 0 || uniform(rng) < std::exp(exponent))
+            {
+                replicas[i].complex.swap(replicas[i+1].complex);
+                acceptedExchanges++;
+            }
+        }
+    }
+    
+    std::cout << "accepted " << acceptedExchanges << " of " << attemptedExchanges << " replica exchanges" << std::endl;
+    
+    unsigned int best = 0;
+    for (unsigned int i = 0; i < replicas.size(); i++)
+    {
+        if (replicas[i].minimalVertices < replicas[best].minimalVertices)
+            best = i;
+    }
+    if (replicas[best].minimalVertices < complex.f(0))
+        complex = MovableComplex(replicas[best].minimalComplex);
+}
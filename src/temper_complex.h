@@ -0,0 +1,38 @@
+//
+//  temper_complex.h
+//  Bistellar
+//
+
+#ifndef Bistellar_temper_complex_h
+#define Bistellar_temper_complex_h
+
+#include "movable_complex.h"
+
+// options of a replica exchange reduction
+struct TemperingOptions
+{
+    // the number of moves proposed to every replica
+    unsigned int rounds;
+    // the number of replicas, their temperatures are spaced geometrically from minTemperature to maxTemperature.
+    // A temperature of 0 selects the default, d/2 and 2*d for a complex of dimension d.
+    unsigned int replicas;
+    double minTemperature;
+    double maxTemperature;
+    // the number of moves proposed to every replica between two exchange phases
+    unsigned int exchangeInterval;
+    // the number of threads the replicas are distributed to
+    unsigned int threads;
+    unsigned int seed;
+    // stops as soon as a complex with at most target vertices is found, 0 never stops early
+    unsigned int target;
+    
+    TemperingOptions();
+};
+
+// reduces complex by parallel tempering and sets it to the complex with the least number of vertices found.
+// Every replica runs a Metropolis chain at its own temperature with the number of facets as energy, so hotter
+// replicas accept more facet increasing moves. Periodically, neighboring replicas exchange their complexes by the
+// Metropolis criterion of the same energy.
+void temper_complex(MovableComplex & complex, const TemperingOptions & options);
+
+#endif
@@ -9,8 +9,15 @@
 #ifndef Bistellar_types_h
 #define Bistellar_types_h
 
+#include <cstddef>
 #include <deque>
+#include <functional>
 #include <utility>
+#include <vector>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include "complex_memory.h"
 
 class Face;
 class BistellarMove;
@@ -23,15 +30,55 @@ inline int vertex_t_compare(const void * v1, const void * v2)
     return *(static_cast<const vertex_t *>(v1)) - *(static_cast<const vertex_t *>(v2));
 }
 
-// type used for face lists
-typedef std::deque< Face > face_list_t;
+// type used for face lists. They allocate from the global heap unless constructed with the allocator of a memory resource.
+typedef std::deque< Face, ResourceAllocator< Face > > face_list_t;
+
+// hash functor for faces, based on the sorted vertex tuple.
+struct FaceHash
+{
+    size_t operator()(const Face & face) const;
+};
+
+// type used for hashed face sets, e.g. the faces of one dimension of a complex
+typedef std::unordered_set< Face, FaceHash, std::equal_to< Face >, ResourceAllocator< Face > > face_set_t;
+// type used for hashed face multimaps, e.g. from link faces to the faces of the moves
+typedef std::unordered_multimap< Face, Face, FaceHash, std::equal_to< Face >, ResourceAllocator< std::pair< const Face, Face > > > face_multimap_t;
+// type used for hashed face counters, e.g. the facets changed since a snapshot
+typedef std::unordered_map< Face, int, FaceHash, std::equal_to< Face >, ResourceAllocator< std::pair< const Face, int > > > face_count_map_t;
+// type used for the stars of vertices, i.e. the facets containing a vertex
+typedef std::unordered_map< vertex_t, face_list_t, std::hash< vertex_t >, std::equal_to< vertex_t >, ResourceAllocator< std::pair< const vertex_t, face_list_t > > > vertex_star_map_t;
 
 // type used for bistellar move lists
 typedef std::deque< BistellarMove > bistellar_move_list_t;
 // type used for bistellar move option lists
 typedef std::deque< std::pair< BistellarMove, bool> > bistellar_move_option_list_t;
+// type used for bistellar move options indexed by the face of the move. Each move is stored
+// together with its position in the list of valid moves, or invalid_move_position if it is not valid.
+typedef std::unordered_map< Face, std::pair< BistellarMove, size_t >, FaceHash, std::equal_to< Face >, ResourceAllocator< std::pair< const Face, std::pair< BistellarMove, size_t > > > > bistellar_move_option_map_t;
+const size_t invalid_move_position = static_cast< size_t >(-1);
+// type used for the dense list of valid moves of one codimension
+typedef std::vector< bistellar_move_option_map_t::value_type * > valid_move_list_t;
+
+// type used for the codimensions a move is selected from
+typedef std::vector< unsigned int > codimension_list_t;
+
+// type of the random number generator used to select moves
+typedef std::mt19937 random_engine_t;
 
 
+// number of vertices a face stores inline, i.e. without allocating memory on the heap.
+// Faces with more vertices fall back to heap storage. 8 vertices cover all moves on complexes up to dimension 6.
+#ifndef Bistellar_inline_vertices
+#define Bistellar_inline_vertices 8
+#endif
+
+// number of 64 bit words of the vertex bitset every face carries. Faces whose vertices are all smaller than
+// 64*Bistellar_vertex_mask_words are represented exactly by the bitset, which turns subset tests, unions,
+// link computations and comparisons into a few word operations. Other faces fall back to the sorted vertex arrays.
+#ifndef Bistellar_vertex_mask_words
+#define Bistellar_vertex_mask_words 2
+#endif
+
 // uncomment this for debug output
 //#define Bistellar_debug_output
 
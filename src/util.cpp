@@ -9,6 +9,32 @@
 #include "util.h"
 #include <stdlib.h>
 #include <string.h>
+#include <string>
+#include <random>
+#include <time.h>
+
+void write_decimal(std::string & buffer, unsigned long long value)
+{
+    // the digits are produced from the last one
+    char digits[20];
+    char * first = digits + sizeof(digits);
+    do
+    {
+        *--first = static_cast< char >('0' + value % 10);
+        value /= 10;
+    }
+    while (value != 0);
+    
+    buffer.append(first, digits + sizeof(digits));
+}
+
+std::string & output_buffer()
+{
+    thread_local std::string buffer;
+    buffer.clear();
+    
+    return buffer;
+}
 
 size_t remove_duplicates(void * base, size_t num, size_t size, int (* comparison)(const void *, const void *))
 {
@@ -77,3 +103,18 @@ size_t remove_from_set(void * base, size_t num, const void * base2, size_t num2,
     
     return new_num;
 }
+
+bool read_flag(std::istream & token)
+{
+    std::string value;
+    token.ignore(1 << 16, '=');
+    token >> value;
+    
+    return value.empty() || value.compare("true") == 0 || value.compare("1") == 0;
+}
+
+unsigned int random_seed()
+{
+    std::random_device device;
+    return device() ^ static_cast< unsigned int >(time(0));
+}
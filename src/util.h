@@ -10,6 +10,7 @@
 #define Bistellar_util_h
 
 #include <iostream>
+#include <string>
 #include <vector>
 #include <deque>
 #include <utility>
@@ -20,15 +21,41 @@ void list_print(std::ostream & os, Iterator first, Iterator last)
 {
     os << "[";
     if (first != last)
-        os << *first << std::flush;
-    for (first++; first != last; first++)
-        os << "," << *first << std::flush;
+    {
+        os << *first;
+        for (first++; first != last; first++)
+            os << "," << *first;
+    }
     os << "]";
 }
 
+// appends the decimal digits of value to buffer
+void write_decimal(std::string & buffer, unsigned long long value);
+
+// returns an empty buffer for formatting output, which keeps its capacity for later calls of the same thread
+std::string & output_buffer();
+
+// appends the faces, or moves, in the format [a,b,...,z] to buffer by their method write.
+template< class Iterator >
+void write_list(std::string & buffer, Iterator first, Iterator last)
+{
+    buffer += '[';
+    if (first != last)
+    {
+        first->write(buffer);
+        for (first++; first != last; first++)
+        {
+            buffer += ',';
+            first->write(buffer);
+        }
+    }
+    buffer += ']';
+}
+
 template< class Container, class Object >
 void list_read(std::istream & is, Container & list)
 {
+    is >> std::ws;
     is.ignore(1, '[');
     
     if (is.eof() || is.peek() == ']')
@@ -49,16 +76,16 @@ void list_read(std::istream & is, Container & list)
     }
 }
 
-template< class T >
-void list_read(std::istream & is, std::vector< T > & list)
+template< class T, class Allocator >
+void list_read(std::istream & is, std::vector< T, Allocator > & list)
 {
-    list_read< std::vector< T >, T >(is, list);
+    list_read< std::vector< T, Allocator >, T >(is, list);
 }
 
-template< class T >
-void list_read(std::istream & is, std::deque< T > & list)
+template< class T, class Allocator >
+void list_read(std::istream & is, std::deque< T, Allocator > & list)
 {
-    list_read< std::deque< T >, T >(is, list);
+    list_read< std::deque< T, Allocator >, T >(is, list);
 }
 
 
@@ -70,6 +97,12 @@ std::ostream & operator<< (std::ostream & os, const std::pair<T,U> & pair )
 }
 
 
+// returns a seed for runs without a given seed, which differs between calls within the same second
+unsigned int random_seed();
+
+// reads the value of a flag option token, e.g. "relabel" or "relabel=true". A flag without value is set.
+bool read_flag(std::istream & token);
+
 // removes all duplivates from the !sorted! array base.
 size_t remove_duplicates(void * base, size_t num, size_t size, int (* comparison)(const void *, const void *));
 // removes all elements of the !sorted! array base2 from the !sorted! array base.
@@ -0,0 +1,181 @@
+//
+//  check_allocations.cpp
+//  Bistellar
+//
+//  Counts the allocations on the global heap by replacing operator new, and checks that faces with few vertices do
+//  not allocate, that containers with a ResourceAllocator allocate from their resource only, and that moves on a
+//  MovableComplex draw nearly all their memory from its ComplexMemory.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include "binary_complex.h"
+#include "complex_memory.h"
+#include "face.h"
+#include "movable_complex.h"
+#include "reduce_complex.h"
+
+static std::atomic< unsigned long long > heapAllocations(0);
+
+void * operator new(std::size_t size)
+{
+    heapAllocations++;
+    if (void * p = std::malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+// std::pmr::new_delete_resource, the upstream of the pools, allocates through the aligned form
+void * operator new(std::size_t size, std::align_val_t alignment)
+{
+    heapAllocations++;
+    std::size_t align = std::max(static_cast< std::size_t >(alignment), sizeof(void *));
+    if (void * p = std::aligned_alloc(align, (std::max< std::size_t >(size, 1) + align - 1) / align * align))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void * p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+// memory resource counting the allocations it passes on to the global heap
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    unsigned long long allocations = 0;
+
+private:
+    void * do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void * p, std::size_t bytes, std::size_t alignment)
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource & other) const noexcept
+    {
+        return this == &other;
+    }
+};
+
+static int failures = 0;
+
+static void check(bool condition, const std::string & message)
+{
+    if (!condition)
+    {
+        std::cerr << "FAIL: " << message << std::endl;
+        failures++;
+    }
+}
+
+// faces up to Bistellar_inline_vertices vertices are built, copied, moved and split without the heap
+static void checkFaces()
+{
+    vertex_t vertices[Bistellar_inline_vertices];
+    for (unsigned int i = 0; i < Bistellar_inline_vertices; i++)
+        vertices[i] = Bistellar_inline_vertices - i;
+
+    unsigned long long before = heapAllocations;
+    {
+        Face face(vertices, Bistellar_inline_vertices - 1);
+        Face copy(face);
+        Face moved(std::move(copy));
+        Face boundary = face.boundaryFace(0);
+        copy = boundary;
+        moved = std::move(boundary);
+    }
+    // the message of check allocates, so the count is taken first
+    bool allocated = (heapAllocations != before);
+    check(!allocated, "faces with inline vertices allocated on the heap");
+}
+
+// a face list with a ResourceAllocator takes its memory from the resource only
+static void checkResourceAllocator()
+{
+    CountingResource resource;
+    vertex_t vertices[3] = {1, 2, 3};
+
+    unsigned long long before = heapAllocations;
+    {
+        face_list_t faces{ResourceAllocator< Face >(&resource)};
+        for (unsigned int i = 0; i < 1000; i++)
+            faces.emplace_back(vertices, 2);
+    }
+    unsigned long long fromHeap = heapAllocations - before;
+    unsigned long long fromResource = resource.allocations;
+    check(fromResource > 0, "face list did not allocate from its resource");
+    // every allocation of the resource reaches the heap once, nothing else may
+    check(fromHeap == fromResource, "face list allocated on the heap past its resource");
+}
+
+// random moves on a complex of the library, after a warm-up which grows the pool of the complex
+static void checkMoves(const std::string & path, unsigned int moves, double maximalPerMove)
+{
+    face_list_t facets;
+    std::string error;
+    if (!read_complex_file(path, facets, error))
+    {
+        check(false, "could not read " + path + ": " + error);
+        return;
+    }
+    MovableComplex complex(facets, facets.front().dimension());
+
+    // reducing and flipping moves, as in the cooling phase of reduce, keep the size of the complex bounded
+    codimension_list_t codimensions;
+    for (unsigned int i = 1; i < complex.dimension()+1; i++)
+        codimensions.push_back(i);
+    random_engine_t rng(1);
+
+    for (unsigned int i = 0; i < moves && numberOfValidMoves(complex, codimensions) > 0; i++)
+        complex.moveComplex(randomValidMove(complex, codimensions, rng));
+
+    unsigned long long before = heapAllocations;
+    unsigned int applied = 0;
+    for (; applied < moves && numberOfValidMoves(complex, codimensions) > 0; applied++)
+        complex.moveComplex(randomValidMove(complex, codimensions, rng));
+    double perMove = static_cast< double >(heapAllocations - before) / std::max(applied, 1u);
+
+    std::cout << path << ": " << perMove << " heap allocations per move over " << applied << " moves" << std::endl;
+    check(applied > 0, path + ": no valid moves");
+    check(perMove <= maximalPerMove, path + ": too many heap allocations per move");
+}
+
+int main()
+{
+    const char * srcdir = std::getenv("top_srcdir");
+    std::string library = std::string(srcdir != 0 ? srcdir : ".") + "/complexes/manifolds/";
+
+    checkFaces();
+    checkResourceAllocator();
+    checkMoves(library + "3Manifolds/bd600cell.scb", 10000, 0.01);
+    checkMoves(library + "5Manifolds/S3xS2.scb", 10000, 0.01);
+    checkMoves(library + "6Manifolds/EK_M6_16.scb", 10000, 0.01);
+
+    if (failures == 0)
+        std::cout << "check_allocations passed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+//
+//  check_read_complex.cpp
+//  Bistellar
+//
+//  Reads complexes given as facet list, file=%f and binary=N by read_complex, several on one line, and checks that
+//  the binary format reproduces the facets written.
+//
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "binary_complex.h"
+#include "facet_parser.h"
+#include "movable_complex.h"
+
+static int failures = 0;
+
+static void check(bool condition, const std::string & message)
+{
+    if (!condition)
+    {
+        std::cerr << "FAIL: " << message << std::endl;
+        failures++;
+    }
+}
+
+// reads a complex from line at the position of is, followed by the word expected
+static bool readWithWord(const std::string & line, std::istream & is, std::istream & input, MovableComplex & complex, const std::string & expected)
+{
+    std::string error, word;
+    if (!read_complex(line, is, input, complex, error))
+    {
+        std::cerr << "malformed complex: " << error << std::endl;
+        return false;
+    }
+    is >> word;
+    if (word != expected)
+    {
+        std::cerr << "expected \"" << expected << "\" after the complex, got \"" << word << "\"" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main()
+{
+    char directory[] = "/tmp/check_read_complex.XXXXXX";
+    if (mkdtemp(directory) == 0)
+    {
+        std::cerr << "could not create a temporary directory" << std::endl;
+        return 1;
+    }
+    std::string textPath = std::string(directory) + "/torus.txt";
+    std::string binaryPath = std::string(directory) + "/torus.scb1";
+
+    // the 7-vertex torus
+    std::string torus = "[[1,2,4],[2,3,5],[3,4,6],[4,5,7],[5,6,1],[6,7,2],[7,1,3],[1,3,4],[2,4,5],[3,5,6],[4,6,7],[5,7,1],[6,1,2],[7,2,3]]";
+    std::ofstream(textPath.c_str()) << torus << std::endl;
+
+    std::istringstream noInput;
+    std::string error;
+    std::string torusLine = torus + " end";
+    std::istringstream torusStream(torusLine);
+    MovableComplex original;
+    check(readWithWord(torusLine, torusStream, noInput, original, "end"), "facet list");
+    check(write_complex_file(binaryPath, original, error), "write " + binaryPath + ": " + error);
+
+    // two complexes from files on one line, one as facet list and one in the binary format
+    MovableComplex first, second;
+    std::string line = "file=" + textPath + " and file=" + binaryPath + " with rounds=10";
+    std::istringstream is(line);
+    check(readWithWord(line, is, noInput, first, "and"), "first of two files on one line");
+    check(readWithWord(line, is, noInput, second, "with"), "second of two files on one line");
+    check(first.faces(2) == original.faces(2), "facet list file differs from the facet list");
+    check(second.faces(2) == original.faces(2), "binary round trip differs from the facet list");
+    check(second.f(0) == 7 && second.f(1) == 21 && second.f(2) == 14, "f-vector of the binary round trip");
+
+    // a complex in the binary format following the line on input, then a facet list on the same line
+    std::ifstream binaryFile(binaryPath.c_str(), std::ios::binary);
+    std::string payload((std::istreambuf_iterator< char >(binaryFile)), std::istreambuf_iterator< char >());
+    std::ostringstream binaryLine;
+    binaryLine << "binary=" << payload.size() << " and [[1,2],[2,3],[3,1]] end";
+    line = binaryLine.str();
+    std::istringstream input(payload);
+    std::istringstream lineStream(line);
+    MovableComplex inline1, inline2;
+    check(readWithWord(line, lineStream, input, inline1, "and"), "binary input");
+    check(readWithWord(line, lineStream, input, inline2, "end"), "facet list after binary input");
+    check(inline1.faces(2) == original.faces(2), "binary input differs from the facet list");
+    check(inline2.f(0) == 3 && inline2.dimension() == 1, "facet list after binary input");
+
+    // a truncated binary complex is rejected
+    std::ofstream(binaryPath.c_str(), std::ios::binary | std::ios::trunc) << payload.substr(0, payload.size() - 1);
+    line = "file=" + binaryPath;
+    std::istringstream truncated(line);
+    MovableComplex rejected;
+    check(!read_complex(line, truncated, noInput, rejected, error), "truncated binary file accepted");
+
+    unlink(textPath.c_str());
+    unlink(binaryPath.c_str());
+    rmdir(directory);
+
+    if (failures == 0)
+        std::cout << "check_read_complex passed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
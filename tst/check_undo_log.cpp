@@ -0,0 +1,104 @@
+//
+//  check_undo_log.cpp
+//  Bistellar
+//
+//  Walks 10000 random bistellar moves on complexes of the library and checks that rollback restores the facets and
+//  the valid moves of every checkpoint exactly, and that commit stops logging.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "binary_complex.h"
+#include "movable_complex.h"
+#include "reduce_complex.h"
+
+static int failures = 0;
+
+static void check(bool condition, const std::string & message)
+{
+    if (!condition)
+    {
+        std::cerr << "FAIL: " << message << std::endl;
+        failures++;
+    }
+}
+
+// applies moves random moves of any codimension with valid moves to complex
+static void walk(MovableComplex & complex, unsigned int moves, random_engine_t & rng)
+{
+    codimension_list_t codimensions;
+    for (unsigned int i = 0; i < complex.dimension()+1; i++)
+        codimensions.push_back(i);
+
+    for (unsigned int i = 0; i < moves && numberOfValidMoves(complex, codimensions) > 0; i++)
+        complex.moveComplex(randomValidMove(complex, codimensions, rng));
+}
+
+// tests if complex has the facets and the valid moves of a complex rebuilt from facets
+static bool matches(const MovableComplex & complex, const face_set_t & facets)
+{
+    if (complex.faces(complex.dimension()) != facets)
+        return false;
+
+    face_list_t list(facets.begin(), facets.end());
+    MovableComplex rebuilt(list, complex.dimension());
+    for (unsigned int d = 0; d < complex.dimension()+1; d++)
+    {
+        if (complex.f(d) != rebuilt.f(d) || complex.numberOfValidMoves(d) != rebuilt.numberOfValidMoves(d))
+            return false;
+    }
+
+    return true;
+}
+
+static void checkComplex(const std::string & path, unsigned int seed)
+{
+    face_list_t facets;
+    std::string error;
+    if (!read_complex_file(path, facets, error))
+    {
+        check(false, "could not read " + path + ": " + error);
+        return;
+    }
+
+    MovableComplex complex(facets, facets.front().dimension());
+    face_set_t original = complex.faces(complex.dimension());
+    random_engine_t rng(seed);
+
+    size_t start = complex.checkpoint();
+    walk(complex, 5000, rng);
+    face_set_t middle = complex.faces(complex.dimension());
+    size_t half = complex.checkpoint();
+    walk(complex, 5000, rng);
+    check(complex.numberOfLoggedMoves() > 0, path + ": no moves logged");
+    check(complex.faces(complex.dimension()) != original, path + ": walk did not change the complex");
+
+    complex.rollback(half);
+    check(matches(complex, middle), path + ": rollback to the second checkpoint");
+    complex.rollback(start);
+    check(matches(complex, original), path + ": rollback of the 10000-move walk");
+    check(complex.numberOfLoggedMoves() == 0, path + ": moves logged after a full rollback");
+
+    // after commit nothing is logged any more
+    complex.checkpoint();
+    walk(complex, 100, rng);
+    complex.commit();
+    walk(complex, 100, rng);
+    check(complex.numberOfLoggedMoves() == 0, path + ": moves logged after commit");
+}
+
+int main()
+{
+    const char * srcdir = std::getenv("top_srcdir");
+    std::string library = std::string(srcdir != 0 ? srcdir : ".") + "/complexes/manifolds/";
+
+    checkComplex(library + "2Manifolds/MoebStrip.scb", 1);
+    checkComplex(library + "3Manifolds/bd600cell.scb", 2);
+    checkComplex(library + "4Manifolds/K3_16.scb", 3);
+    checkComplex(library + "5Manifolds/S3xS2.scb", 4);
+
+    if (failures == 0)
+        std::cout << "check_undo_log passed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}